@@ -0,0 +1,716 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+// Micro and macro benchmarks of the hot paths: session persistence, every
+// statistics getter on generated fixtures, activity map rendering and
+// hit-testing, timer ticks, the multi-timer engine and settings load/save. Results are written as
+// JSON so runs can be diffed.
+//
+// Each benchmark is calibrated to run for about --min-time-ms per
+// repetition, then repeated; per-operation times are reported as min,
+// median, mean and max over the repetitions. Fixtures are generated from a
+// fixed seed and date range and kept in --fixture-dir, so repeated runs
+// measure the same data.
+
+#include "clock.h"
+#include "timer.h"
+#include "multitimerengine.h"
+#include "settings.h"
+#include "databasemanager.h"
+#include "analyticsengine.h"
+#include "activitymaprenderer.h"
+#include "pomodoroactivitymap.h"
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QPainter>
+#include <QRandomGenerator>
+#include <QSettings>
+#include <QSysInfo>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QFile>
+#include <QDir>
+
+#include <algorithm>
+#include <functional>
+
+namespace
+{
+    // Keeps results alive so the optimizer cannot drop the measured work
+    volatile qint64 g_sink = 0;
+
+    // Fixture data covers whole days up to this date
+    const QDate kFixtureEnd(2025, 12, 31);
+    constexpr quint32 kFixtureSeed = 20250309;
+
+    // Runs benchmark bodies and collects their timings. A body receives an
+    // iteration count and performs the operation that many times, so any
+    // setup it does outside the loop is not measured per operation.
+    class BenchRunner
+    {
+    public:
+        BenchRunner(const QString& filter, int repetitions, qint64 minTimeNs)
+            : m_filter(filter)
+              , m_repetitions(qMax(1, repetitions))
+              , m_minTimeNs(minTimeNs)
+        {
+        }
+
+        bool wants(const QString& name) const
+        {
+            return m_filter.isEmpty() || name.contains(m_filter);
+        }
+
+        void run(const QString& name, const QString& fixture, const std::function<void(qint64)>& body)
+        {
+            if (!wants(name))
+            {
+                return;
+            }
+
+            // One call to warm up and estimate the cost of an operation
+            QElapsedTimer timer;
+            timer.start();
+            body(1);
+            qint64 singleNs = qMax<qint64>(1, timer.nsecsElapsed());
+            qint64 iterations = qBound<qint64>(1, m_minTimeNs / singleNs, 10000000);
+
+            QVector<double> nsPerOp;
+            for (int rep = 0; rep < m_repetitions; rep++)
+            {
+                timer.restart();
+                body(iterations);
+                nsPerOp.append(double(timer.nsecsElapsed()) / iterations);
+            }
+            std::sort(nsPerOp.begin(), nsPerOp.end());
+
+            double mean = 0.0;
+            for (double value : nsPerOp)
+            {
+                mean += value;
+            }
+            mean /= nsPerOp.size();
+            double median = nsPerOp[nsPerOp.size() / 2];
+
+            QJsonObject times;
+            times["min"] = nsPerOp.first();
+            times["median"] = median;
+            times["mean"] = mean;
+            times["max"] = nsPerOp.last();
+
+            QJsonObject result;
+            result["name"] = name;
+            result["fixture"] = fixture;
+            result["iterations"] = iterations;
+            result["repetitions"] = m_repetitions;
+            result["nsPerOp"] = times;
+            result["opsPerSecond"] = median > 0 ? 1e9 / median : 0.0;
+            m_results.append(result);
+
+            QTextStream(stderr) << name << " [" << fixture << "] " << QString::number(median, 'f', 0)
+                << " ns/op\n";
+        }
+
+        QJsonArray results() const
+        {
+            return m_results;
+        }
+
+    private:
+        QString m_filter;
+        int m_repetitions;
+        qint64 m_minTimeNs;
+        QJsonArray m_results;
+    };
+
+    // Days the fixture's sessions are spread over
+    int fixtureSpanDays(qint64 rows)
+    {
+        return int(qBound<qint64>(30, rows / 10, 3650));
+    }
+
+    QString fixtureName(qint64 rows)
+    {
+        if (rows >= 1000000 && rows % 1000000 == 0)
+        {
+            return QString("%1M").arg(rows / 1000000);
+        }
+        if (rows >= 1000 && rows % 1000 == 0)
+        {
+            return QString("%1k").arg(rows / 1000);
+        }
+        return QString::number(rows);
+    }
+
+    qint64 countRows(const QString& connectionName)
+    {
+        QSqlQuery query(QSqlDatabase::database(connectionName));
+        if (!query.exec("SELECT COUNT(*) FROM pomodoro_sessions") || !query.next())
+        {
+            return -1;
+        }
+        return query.value(0).toLongLong();
+    }
+
+    // Creates (or reuses) a database with `rows` work sessions ending on kFixtureEnd
+    bool prepareFixture(const QString& path, qint64 rows)
+    {
+        {
+            // Schema comes from the application itself
+            DatabaseManager dbManager;
+            dbManager.setConnectionName("bench-schema");
+            dbManager.setDatabasePath(path);
+            if (!dbManager.initialize())
+            {
+                return false;
+            }
+        }
+
+        bool ok = true;
+        {
+            // Bulk insert on a plain connection: one prepared statement, one transaction
+            QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "bench-fixture");
+            db.setDatabaseName(path);
+            if (!db.open())
+            {
+                return false;
+            }
+
+            qint64 existing = countRows("bench-fixture");
+            if (existing != rows)
+            {
+                QTextStream(stderr) << "Generating fixture " << fixtureName(rows) << " at " << path << "\n";
+
+                QSqlQuery clear(db);
+                clear.exec("DELETE FROM pomodoro_sessions");
+
+                db.transaction();
+                QSqlQuery insert(db);
+                insert.prepare("INSERT INTO pomodoro_sessions "
+                    "(start_time, duration_seconds, completed, paused_seconds, interruptions) "
+                    "VALUES (?, ?, ?, ?, ?)");
+
+                QRandomGenerator random(kFixtureSeed);
+                const int spanDays = fixtureSpanDays(rows);
+                const QDate firstDay = kFixtureEnd.addDays(1 - spanDays);
+
+                for (qint64 i = 0; i < rows && ok; i++)
+                {
+                    // Evenly over the span, at random times between 07:00 and 21:00
+                    QDate day = firstDay.addDays(i * spanDays / rows);
+                    QDateTime start(day, QTime(7, 0).addSecs(random.bounded(14 * 3600)));
+                    bool completed = random.bounded(10) != 0;
+
+                    insert.bindValue(0, start);
+                    insert.bindValue(1, completed ? 1500 : random.bounded(60, 1500));
+                    insert.bindValue(2, completed ? 1 : 0);
+                    insert.bindValue(3, random.bounded(4) == 0 ? random.bounded(30, 600) : 0);
+                    insert.bindValue(4, random.bounded(4) == 0 ? random.bounded(1, 4) : 0);
+                    ok = insert.exec();
+                }
+
+                ok = db.commit() && ok;
+            }
+            db.close();
+        }
+        QSqlDatabase::removeDatabase("bench-fixture");
+        return ok;
+    }
+
+    void benchPersistence(BenchRunner& runner, const QString& scratchDir)
+    {
+        DatabaseManager dbManager;
+        dbManager.setConnectionName("bench-persistence");
+        dbManager.setDatabasePath(QDir(scratchDir).filePath("persistence.db"));
+        if (!dbManager.initialize())
+        {
+            QTextStream(stderr) << "Skipping persistence benchmarks: no database\n";
+            return;
+        }
+
+        QDateTime start(kFixtureEnd, QTime(9, 0));
+        QByteArray timeline = QByteArray::fromHex("2a0b13");
+
+        // Autocommit: every session is its own transaction, as recorded live
+        runner.run("persistence.recordPomodoroSession", "autocommit", [&](qint64 iterations)
+        {
+            for (qint64 i = 0; i < iterations; i++)
+            {
+                g_sink += dbManager.recordPomodoroSession(start, 1500, true, 30, 1, timeline);
+            }
+        });
+
+        // Batched, as the simulator writes
+        runner.run("persistence.recordPomodoroSession", "batched", [&](qint64 iterations)
+        {
+            dbManager.beginBatch();
+            for (qint64 i = 0; i < iterations; i++)
+            {
+                g_sink += dbManager.recordPomodoroSession(start, 1500, true, 30, 1, timeline);
+            }
+            dbManager.commitBatch();
+        });
+    }
+
+    void benchActivityMapRendering(BenchRunner& runner, DatabaseManager* dbManager, const QString& fixture,
+                                   const QDate& first, const QDate& last)
+    {
+        const QSize size(900, 240);
+        QImage image(size, QImage::Format_ARGB32_Premultiplied);
+        QFont font("DejaVu Sans");
+        font.setPixelSize(11);
+
+        // What the widget does to rebuild its backing image, for each level of detail
+        const QPair<const char*, ActivityGranularity> levels[] = {
+            {"day", ActivityGranularity::Day},
+            {"week", ActivityGranularity::Week},
+            {"month", ActivityGranularity::Month}
+        };
+        for (const auto& level : levels)
+        {
+            QString name = QString("activity_map.render.%1").arg(level.first);
+            if (!runner.wants(name))
+            {
+                continue;
+            }
+
+            ActivityMapRenderer renderer;
+            renderer.setDateRange(level.second == ActivityGranularity::Day ? last.addDays(-364) : first, last,
+                                  level.second);
+            renderer.setLocale(QLocale::c());
+            renderer.loadAll(dbManager);
+            renderer.setViewport(qMax(0, renderer.columnCount() - renderer.visibleColumnCount(size.width())),
+                                 size.width());
+
+            runner.run(name, fixture, [&](qint64 iterations)
+            {
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    image.fill(Qt::transparent);
+                    QPainter painter(&image);
+                    renderer.draw(painter, size, font, Qt::black);
+                }
+                g_sink += image.pixel(60, 60);
+            });
+        }
+
+        // Hit-testing as on mouse move: random points over the widget
+        if (runner.wants("activity_map.hit_test"))
+        {
+            ActivityMapRenderer renderer;
+            renderer.setDateRange(last.addDays(-364), last, ActivityGranularity::Day);
+            renderer.loadAll(dbManager);
+            renderer.setViewport(0, size.width());
+
+            QRandomGenerator random(kFixtureSeed);
+            QVector<QPoint> points(4096);
+            for (QPoint& point : points)
+            {
+                point = QPoint(random.bounded(size.width()), random.bounded(size.height()));
+            }
+
+            runner.run("activity_map.hit_test", fixture, [&](qint64 iterations)
+            {
+                qint64 sum = 0;
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    sum += renderer.bucketAt(points[int(i & 4095)]);
+                }
+                g_sink += sum;
+            });
+        }
+    }
+
+    void benchStatistics(BenchRunner& runner, const QString& path, qint64 rows)
+    {
+        const QString fixture = fixtureName(rows);
+        const QString connectionName = "bench-stats-" + fixture;
+        {
+            DatabaseManager dbManager;
+            dbManager.setConnectionName(connectionName);
+            dbManager.setDatabasePath(path);
+            dbManager.setReadOnly(true);
+            if (!dbManager.initialize())
+            {
+                QTextStream(stderr) << "Skipping statistics on " << fixture << ": no database\n";
+                return;
+            }
+
+            const QDate last = kFixtureEnd;
+            const QDate first = kFixtureEnd.addDays(1 - fixtureSpanDays(rows));
+            const QDate monthAgo = last.addDays(-29);
+
+            runner.run("stats.getTotalCompletedPomodoros", fixture, [&](qint64 iterations)
+            {
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    g_sink += dbManager.getTotalCompletedPomodoros(last);
+                }
+            });
+            runner.run("stats.getTotalWorkMinutes", fixture, [&](qint64 iterations)
+            {
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    g_sink += dbManager.getTotalWorkMinutes(last);
+                }
+            });
+            runner.run("stats.getAverageSessionLength.30d", fixture, [&](qint64 iterations)
+            {
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    g_sink += qint64(dbManager.getAverageSessionLength(monthAgo, last));
+                }
+            });
+            runner.run("stats.getSessionTimelines.30d", fixture, [&](qint64 iterations)
+            {
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    g_sink += dbManager.getSessionTimelines(monthAgo, last).size();
+                }
+            });
+            runner.run("stats.getDailyPomodoroStats.7d", fixture, [&](qint64 iterations)
+            {
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    g_sink += dbManager.getDailyPomodoroStats(last.addDays(-6), last).size();
+                }
+            });
+
+            const QPair<const char*, ActivityGranularity> levels[] = {
+                {"day", ActivityGranularity::Day},
+                {"week", ActivityGranularity::Week},
+                {"month", ActivityGranularity::Month}
+            };
+            for (const auto& level : levels)
+            {
+                runner.run(QString("stats.getActivityBuckets.all.%1").arg(level.first), fixture,
+                           [&](qint64 iterations)
+                           {
+                               for (qint64 i = 0; i < iterations; i++)
+                               {
+                                   g_sink += dbManager.getActivityBuckets(first, last, level.second).size();
+                               }
+                           });
+            }
+            runner.run("stats.getMaxActivityBucket.all.day", fixture, [&](qint64 iterations)
+            {
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    g_sink += dbManager.getMaxActivityBucket(first, last, ActivityGranularity::Day);
+                }
+            });
+
+            AnalyticsEngine engine;
+            runner.run("stats.analytics.analyze.90d", fixture, [&](qint64 iterations)
+            {
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    g_sink += engine.analyze(&dbManager, last.addDays(-89), last).thisWeek;
+                }
+            });
+
+            benchActivityMapRendering(runner, &dbManager, fixture, first, last);
+        }
+    }
+
+    void benchActivityMapWidget(BenchRunner& runner, const QString& path, qint64 rows)
+    {
+        if (!runner.wants("activity_map.widget_paint"))
+        {
+            return;
+        }
+
+        const QString fixture = fixtureName(rows);
+        DatabaseManager dbManager; // Outlives the map, which keeps a pointer to it
+        dbManager.setConnectionName("bench-widget-" + fixture);
+        dbManager.setDatabasePath(path);
+        dbManager.setReadOnly(true);
+        if (!dbManager.initialize())
+        {
+            QTextStream(stderr) << "Skipping widget paint on " << fixture << ": no database\n";
+            return;
+        }
+
+        // Repaint of the widget with its backing image already built from the
+        // fixture: the cost of every hover and scroll-free update
+        PomodoroActivityMap map;
+        map.resize(900, 240);
+        map.setDatabaseManager(&dbManager);
+        map.setDateRange(kFixtureEnd.addDays(-364), kFixtureEnd);
+
+        QImage image(map.size(), QImage::Format_ARGB32_Premultiplied);
+        map.render(&image); // Lays the map out, which requests the visible chunks
+
+        // Chunks arrive from the loader thread as queued events
+        QElapsedTimer waited;
+        waited.start();
+        while (map.isLoading() && waited.elapsed() < 120000)
+        {
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 50);
+            QThread::msleep(1);
+        }
+        if (map.isLoading())
+        {
+            QTextStream(stderr) << "Skipping widget paint on " << fixture << ": loading timed out\n";
+            return;
+        }
+        map.render(&image);
+
+        runner.run("activity_map.widget_paint", fixture, [&](qint64 iterations)
+        {
+            for (qint64 i = 0; i < iterations; i++)
+            {
+                map.render(&image);
+            }
+            g_sink += image.pixel(60, 60);
+        });
+    }
+
+    void benchTimer(BenchRunner& runner)
+    {
+        Clock* previousClock = Clock::instance();
+        SimulatedClock clock(QDateTime(kFixtureEnd, QTime(8, 0)));
+        Clock::setInstance(&clock);
+
+        {
+            Timer timer;
+            timer.setClock(&clock);
+            timer.setTickConsumerVisible(true);
+
+            qint64 ticks = 0;
+            QObject::connect(&timer, &Timer::timerTick, [&ticks](int)
+            {
+                ticks++;
+            });
+
+            // One operation per tick delivered to a visible display
+            runner.run("timer.tick", "visible", [&](qint64 iterations)
+            {
+                qint64 target = ticks + iterations;
+                while (ticks < target)
+                {
+                    if (timer.getState() != Timer::TimerState::Running)
+                    {
+                        timer.start();
+                    }
+                    clock.runNextWakeup();
+                }
+            });
+
+            // Whole sessions with nothing on screen: completion wakeups only
+            timer.setTickConsumerVisible(false);
+            runner.run("timer.session", "headless", [&](qint64 iterations)
+            {
+                for (qint64 i = 0; i < iterations; i++)
+                {
+                    timer.start();
+                    while (timer.getState() == Timer::TimerState::Running && clock.runNextWakeup())
+                    {
+                    }
+                }
+            });
+        }
+
+        Clock::setInstance(previousClock);
+    }
+
+    void benchMultiTimer(BenchRunner& runner)
+    {
+        if (!runner.wants("multitimer."))
+        {
+            return;
+        }
+
+        // Engine time is driven by hand, so only the engine's own work is timed
+        constexpr int kTimers = 100000;
+        MultiTimerEngine engine;
+        engine.setAutoAdvance(false);
+        for (int i = 0; i < kTimers; i++)
+        {
+            engine.addTimer();
+        }
+
+        // One start (arm) and pause (cancel) per operation, spread over every timer
+        runner.run("multitimer.arm_cancel", "100k", [&](qint64 iterations)
+        {
+            for (qint64 i = 0; i < iterations; i++)
+            {
+                int id = int(i % kTimers);
+                engine.start(id);
+                engine.pause(id);
+            }
+        });
+
+        // One operation per timer that is armed and then fires; all of them
+        // are running at once before time moves past their deadlines
+        for (int i = 0; i < kTimers; i++)
+        {
+            engine.reset(i);
+        }
+        qint64 expired = 0;
+        QObject::connect(&engine, &MultiTimerEngine::timerCompleted, [&expired](int, Timer::TimerMode)
+        {
+            expired++;
+        });
+        runner.run("multitimer.expire", "100k", [&](qint64 iterations)
+        {
+            for (qint64 done = 0; done < iterations;)
+            {
+                int batch = int(qMin<qint64>(kTimers, iterations - done));
+                for (int id = 0; id < batch; id++)
+                {
+                    engine.start(id);
+                }
+                engine.advanceTo(engine.now() + 60 * 60 * 1000); // Past any step of the plan
+                done += batch;
+            }
+            g_sink += expired + engine.armedCount();
+        });
+    }
+
+    void benchSettings(BenchRunner& runner, const QString& scratchDir)
+    {
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
+        // Settings live in an INI file under the scratch directory, never the user's
+        QSettings::setPath(QSettings::NativeFormat, QSettings::UserScope, scratchDir);
+        QSettings::setPath(QSettings::IniFormat, QSettings::UserScope, scratchDir);
+
+        Settings settings;
+        runner.run("settings.load", "ini", [&](qint64 iterations)
+        {
+            for (qint64 i = 0; i < iterations; i++)
+            {
+                settings.loadSettings();
+            }
+            g_sink += settings.getWorkDuration();
+        });
+        runner.run("settings.save", "ini", [&](qint64 iterations)
+        {
+            for (qint64 i = 0; i < iterations; i++)
+            {
+                settings.saveSettings();
+            }
+        });
+#else
+        // Native settings here are not files we can redirect away from the user's
+        Q_UNUSED(runner);
+        Q_UNUSED(scratchDir);
+        QTextStream(stderr) << "Skipping settings benchmarks on this platform\n";
+#endif
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // Widgets are rendered to images; no display needed
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pomodoro-bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks of the Ziga-Pomodoro hot paths, as JSON");
+    parser.addHelpOption();
+    parser.addOption({"sizes", "Fixture sizes in rows (default 1000,100000).", "rows", "1000,100000"});
+    parser.addOption({"huge", "Also run the 10M-row fixture (slow to generate the first time)."});
+    parser.addOption({"fixture-dir", "Where fixtures are kept between runs (default: temporary).", "dir"});
+    parser.addOption({"filter", "Only benchmarks whose name contains this text.", "text"});
+    parser.addOption({"repetitions", "Measured repetitions per benchmark (default 5).", "count", "5"});
+    parser.addOption({"min-time-ms", "Target duration of one repetition (default 100).", "ms", "100"});
+    parser.addOption({"out", "Write the JSON here instead of stdout.", "path"});
+    parser.process(app);
+
+    QList<qint64> sizes;
+    for (const QString& size : parser.value("sizes").split(',')) // Empty parts are not positive
+    {
+        if (size.toLongLong() > 0)
+        {
+            sizes.append(size.toLongLong());
+        }
+    }
+    if (parser.isSet("huge"))
+    {
+        sizes.append(10000000);
+    }
+
+    QTemporaryDir scratch;
+    QString fixtureDir = parser.isSet("fixture-dir") ? parser.value("fixture-dir") : scratch.path();
+    if (!QDir().mkpath(fixtureDir) || !scratch.isValid())
+    {
+        QTextStream(stderr) << "Cannot create " << fixtureDir << "\n";
+        return 1;
+    }
+
+    BenchRunner runner(parser.value("filter"), parser.value("repetitions").toInt(),
+                       parser.value("min-time-ms").toLongLong() * 1000000);
+
+    benchPersistence(runner, scratch.path());
+
+    QJsonArray fixtures;
+    for (qint64 rows : sizes)
+    {
+        QString path = QDir(fixtureDir).filePath(QString("fixture-%1.db").arg(fixtureName(rows)));
+        if (!prepareFixture(path, rows))
+        {
+            QTextStream(stderr) << "Failed to prepare fixture " << path << "\n";
+            return 1;
+        }
+
+        QJsonObject fixture;
+        fixture["name"] = fixtureName(rows);
+        fixture["rows"] = rows;
+        fixture["days"] = fixtureSpanDays(rows);
+        fixtures.append(fixture);
+
+        benchStatistics(runner, path, rows);
+        benchActivityMapWidget(runner, path, rows);
+    }
+
+    benchTimer(runner);
+    benchMultiTimer(runner);
+    benchSettings(runner, scratch.path());
+
+    QJsonObject environment;
+    environment["qt"] = QString(qVersion());
+    environment["os"] = QSysInfo::prettyProductName();
+    environment["cpu"] = QSysInfo::currentCpuArchitecture();
+    environment["threads"] = QThread::idealThreadCount();
+#ifdef NDEBUG
+    environment["build"] = "release";
+#else
+    environment["build"] = "debug";
+#endif
+
+    QJsonObject report;
+    report["version"] = 1;
+    report["environment"] = environment;
+    report["fixtures"] = fixtures;
+    report["results"] = runner.results();
+
+    QByteArray json = QJsonDocument(report).toJson(QJsonDocument::Indented);
+    if (parser.isSet("out"))
+    {
+        QFile file(parser.value("out"));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size())
+        {
+            QTextStream(stderr) << "Failed to write " << parser.value("out") << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        QTextStream(stdout) << json;
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "activityloader.h"
+
+namespace
+{
+    // Connection names are global, so every loader numbers its own
+    std::atomic<int> g_loaderCount(0);
+}
+
+template <typename Function>
+void ActivityLoader::runOnLoader(Function function, Qt::ConnectionType type)
+{
+    QMetaObject::invokeMethod(m_context, std::move(function), type);
+}
+
+ActivityLoader::ActivityLoader(QObject* parent)
+    : QObject(parent)
+      , m_context(new QObject())
+      , m_connectionName(QString("activity-loader-%1").arg(++g_loaderCount))
+      , m_db(nullptr)
+      , m_hasDatabase(false)
+      , m_generation(0)
+{
+    m_thread.setObjectName("ActivityLoader");
+    m_context->moveToThread(&m_thread);
+    m_thread.start(QThread::LowPriority);
+}
+
+ActivityLoader::~ActivityLoader()
+{
+    cancel();
+
+    // The connection belongs to the loader thread; deleting it removes it
+    runOnLoader([this]()
+    {
+        delete m_db;
+        m_db = nullptr;
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait();
+    delete m_context;
+}
+
+void ActivityLoader::setDatabasePath(const QString& path)
+{
+    cancel();
+    m_hasDatabase = !path.isEmpty();
+
+    runOnLoader([this, path]()
+    {
+        delete m_db;
+        m_db = nullptr;
+
+        if (path.isEmpty())
+        {
+            return;
+        }
+
+        // SQLite connections are per thread, so the loader gets its own
+        m_db = new DatabaseManager();
+        m_db->setConnectionName(m_connectionName);
+        m_db->setReadOnly(true); // The main connection owns the schema
+        m_db->setDatabasePath(path);
+        if (!m_db->initialize())
+        {
+            delete m_db;
+            m_db = nullptr;
+        }
+    });
+}
+
+bool ActivityLoader::hasDatabase() const
+{
+    return m_hasDatabase;
+}
+
+quint64 ActivityLoader::request(ActivityGranularity granularity, const QDate& from, const QDate& to,
+                                const QVector<Chunk>& chunks, bool withMaximum)
+{
+    quint64 requestId = ++m_generation;
+
+    runOnLoader([this, requestId, granularity, from, to, chunks, withMaximum]()
+    {
+        if (!m_db || !isCurrent(requestId))
+        {
+            return;
+        }
+
+        if (withMaximum)
+        {
+            int maximum = m_db->getMaxActivityBucket(from, to, granularity);
+            QMetaObject::invokeMethod(this, [this, requestId, maximum]()
+            {
+                if (isCurrent(requestId))
+                {
+                    emit maximumLoaded(requestId, maximum);
+                }
+            }, Qt::QueuedConnection);
+        }
+
+        runChunk(requestId, granularity, chunks, 0);
+    });
+
+    return requestId;
+}
+
+void ActivityLoader::cancel()
+{
+    ++m_generation;
+}
+
+void ActivityLoader::runChunk(quint64 requestId, ActivityGranularity granularity, const QVector<Chunk>& chunks,
+                              int index)
+{
+    if (index >= chunks.size() || !m_db || !isCurrent(requestId))
+    {
+        return;
+    }
+
+    const Chunk chunk = chunks[index];
+    QList<ActivityBucket> buckets = m_db->getActivityBuckets(chunk.from, chunk.to, granularity);
+
+    QMetaObject::invokeMethod(this, [this, requestId, chunk, buckets]()
+    {
+        if (isCurrent(requestId))
+        {
+            emit chunkLoaded(requestId, chunk.from, chunk.to, buckets);
+        }
+    }, Qt::QueuedConnection);
+
+    // One chunk per event, so a newer request or a path change runs in between
+    runOnLoader([this, requestId, granularity, chunks, index]()
+    {
+        runChunk(requestId, granularity, chunks, index + 1);
+    });
+}
+
+bool ActivityLoader::isCurrent(quint64 requestId) const
+{
+    return m_generation.load() == requestId;
+}
@@ -0,0 +1,64 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_ACTIVITYLOADER_H
+#define ZIGA_POMODORO_ACTIVITYLOADER_H
+
+#include <QObject>
+#include <QThread>
+#include <QDate>
+#include <QVector>
+#include <atomic>
+
+#include "databasemanager.h"
+
+// Fetches activity buckets on its own thread and database connection, one
+// chunk at a time. Every request supersedes the previous one: chunks still
+// queued for an older request are skipped and its results never delivered.
+class ActivityLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Chunk
+    {
+        QDate from;
+        QDate to;
+    };
+
+    explicit ActivityLoader(QObject* parent = nullptr);
+    ~ActivityLoader() override;
+
+    // Opens the loader's own connection to this database; empty disables loading
+    void setDatabasePath(const QString& path);
+    bool hasDatabase() const;
+
+    // Loads the maximum bucket of [from, to] if asked, then the chunks in the
+    // given order. Returns the id the result signals carry.
+    quint64 request(ActivityGranularity granularity, const QDate& from, const QDate& to,
+                    const QVector<Chunk>& chunks, bool withMaximum);
+    void cancel();
+
+signals:
+    void maximumLoaded(quint64 requestId, int maximum);
+    void chunkLoaded(quint64 requestId, const QDate& from, const QDate& to, const QList<ActivityBucket>& buckets);
+
+private:
+    // Loader thread
+    void runChunk(quint64 requestId, ActivityGranularity granularity, const QVector<Chunk>& chunks, int index);
+
+    bool isCurrent(quint64 requestId) const;
+
+    template <typename Function>
+    void runOnLoader(Function function, Qt::ConnectionType type = Qt::QueuedConnection);
+
+    QThread m_thread;
+    QObject* m_context; // Lives on m_thread; work queued to it runs there
+    QString m_connectionName; // Unique per loader
+    DatabaseManager* m_db; // Loader thread only
+    bool m_hasDatabase;
+    std::atomic<quint64> m_generation;
+};
+
+#endif // ZIGA_POMODORO_ACTIVITYLOADER_H
@@ -0,0 +1,615 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "activitymaprenderer.h"
+#include <QPainter>
+
+#ifdef HAVE_QT_SVG
+#include <QSvgGenerator>
+#endif
+
+namespace
+{
+// Top-left of the cell grid, leaving room for weekday and month labels
+constexpr int kGridLeft = 50;
+constexpr int kGridTop = 35;
+
+// Space right of the grid
+constexpr int kGridRightMargin = 10;
+
+// Weekly bars are narrow so a few years fit in view
+constexpr int kWeekBarWidth = 8;
+constexpr int kWeekBarSpacing = 2;
+
+// The automatic level of detail allows this many pages of scrolling
+constexpr int kAutoDetailPages = 2;
+
+// The legend needs this much width, and this much height below the grid
+constexpr int kMinimumWidth = 260;
+constexpr int kLegendHeight = 50;
+}
+
+ActivityMapRenderer::ActivityMapRenderer()
+    : m_granularity(ActivityGranularity::Day)
+      , m_bucketCount(0)
+      , m_columnCount(0)
+      , m_loadedFirst(0)
+      , m_firstColumn(0)
+      , m_visibleColumns(1)
+      , m_cellSize(18)
+      , m_cellSpacing(3)
+      , m_maxPomodoros(1)
+{
+    buildColorTable();
+}
+
+void ActivityMapRenderer::setDateRange(const QDate& startDate, const QDate& endDate, ActivityGranularity granularity)
+{
+    m_startDate = startDate;
+    m_endDate = endDate;
+    m_granularity = granularity;
+
+    switch (m_granularity)
+    {
+    case ActivityGranularity::Week:
+        m_firstBucketDate = m_startDate.addDays(1 - m_startDate.dayOfWeek());
+        break;
+    case ActivityGranularity::Month:
+        m_firstBucketDate = QDate(m_startDate.year(), m_startDate.month(), 1);
+        break;
+    case ActivityGranularity::Day:
+    default:
+        m_firstBucketDate = m_startDate;
+        break;
+    }
+
+    m_bucketCount = m_endDate >= m_startDate ? bucketForDate(m_endDate) + 1 : 0;
+    m_columnCount = m_granularity == ActivityGranularity::Day ? (m_bucketCount + 6) / 7 : m_bucketCount;
+
+    setWindow(0, QVector<int>(), QVector<int>());
+    m_firstColumn = qBound(0, m_firstColumn, qMax(0, m_columnCount - 1));
+}
+
+QDate ActivityMapRenderer::startDate() const
+{
+    return m_startDate;
+}
+
+QDate ActivityMapRenderer::endDate() const
+{
+    return m_endDate;
+}
+
+ActivityGranularity ActivityMapRenderer::granularity() const
+{
+    return m_granularity;
+}
+
+int ActivityMapRenderer::bucketCount() const
+{
+    return m_bucketCount;
+}
+
+int ActivityMapRenderer::columnCount() const
+{
+    return m_columnCount;
+}
+
+ActivityGranularity ActivityMapRenderer::autoGranularity(const QDate& startDate, const QDate& endDate, int gridWidth)
+{
+    ActivityMapRenderer renderer;
+    int days = qMax(0, int(startDate.daysTo(endDate)) + 1);
+    gridWidth = qMax(1, gridWidth);
+
+    if ((days + 6) / 7 * (renderer.m_cellSize + renderer.m_cellSpacing) <= kAutoDetailPages * gridWidth)
+    {
+        return ActivityGranularity::Day;
+    }
+    if ((days / 7 + 2) * (kWeekBarWidth + kWeekBarSpacing) <= kAutoDetailPages * gridWidth)
+    {
+        return ActivityGranularity::Week;
+    }
+    return ActivityGranularity::Month;
+}
+
+void ActivityMapRenderer::setWindow(int first, const QVector<int>& pomodoros, const QVector<int>& seconds)
+{
+    m_loadedFirst = first;
+    m_pomodoros = pomodoros;
+    m_seconds = seconds;
+}
+
+int ActivityMapRenderer::windowFirst() const
+{
+    return m_loadedFirst;
+}
+
+int ActivityMapRenderer::windowSize() const
+{
+    return m_pomodoros.size();
+}
+
+void ActivityMapRenderer::setBucket(int bucket, int pomodoros, int seconds)
+{
+    int index = bucket - m_loadedFirst;
+    if (index >= 0 && index < m_pomodoros.size())
+    {
+        m_pomodoros[index] = pomodoros;
+        m_seconds[index] = seconds;
+    }
+}
+
+int ActivityMapRenderer::pomodorosAt(int bucket) const
+{
+    int index = bucket - m_loadedFirst;
+    return index >= 0 && index < m_pomodoros.size() ? m_pomodoros[index] : -1;
+}
+
+int ActivityMapRenderer::secondsAt(int bucket) const
+{
+    int index = bucket - m_loadedFirst;
+    return index >= 0 && index < m_seconds.size() ? m_seconds[index] : 0;
+}
+
+int ActivityMapRenderer::minutesAt(int bucket) const
+{
+    return secondsAt(bucket) / 60;
+}
+
+void ActivityMapRenderer::setMaximum(int maximum)
+{
+    maximum = qMax(1, maximum);
+    if (maximum != m_maxPomodoros)
+    {
+        m_maxPomodoros = maximum;
+        buildColorTable();
+    }
+}
+
+int ActivityMapRenderer::maximum() const
+{
+    return m_maxPomodoros;
+}
+
+bool ActivityMapRenderer::loadAll(DatabaseManager* dbManager)
+{
+    if (!dbManager || !dbManager->isInitialized())
+    {
+        return false;
+    }
+
+    QVector<int> pomodoros(m_bucketCount, 0);
+    QVector<int> seconds(m_bucketCount, 0);
+    const QList<ActivityBucket> buckets = dbManager->getActivityBuckets(m_startDate, m_endDate, m_granularity);
+    for (const ActivityBucket& bucket : buckets)
+    {
+        int index = bucketForDate(bucket.start);
+        if (index >= 0 && index < m_bucketCount)
+        {
+            pomodoros[index] = bucket.pomodoros;
+            seconds[index] = bucket.seconds;
+        }
+    }
+
+    setWindow(0, pomodoros, seconds);
+    setMaximum(dbManager->getMaxActivityBucket(m_startDate, m_endDate, m_granularity));
+    return true;
+}
+
+void ActivityMapRenderer::setViewport(int firstColumn, int width)
+{
+    m_firstColumn = qMax(0, firstColumn);
+    m_visibleColumns = visibleColumnCount(width);
+}
+
+int ActivityMapRenderer::firstColumn() const
+{
+    return m_firstColumn;
+}
+
+int ActivityMapRenderer::lastVisibleColumn() const
+{
+    return qMin(m_columnCount - 1, m_firstColumn + m_visibleColumns - 1);
+}
+
+int ActivityMapRenderer::visibleColumnCount() const
+{
+    return m_visibleColumns;
+}
+
+int ActivityMapRenderer::visibleColumnCount(int width) const
+{
+    return qMax(1, (width - kGridLeft - kGridRightMargin) / columnPitch());
+}
+
+void ActivityMapRenderer::setLocale(const QLocale& locale)
+{
+    m_locale = locale;
+}
+
+int ActivityMapRenderer::gridLeft() const
+{
+    return kGridLeft;
+}
+
+int ActivityMapRenderer::gridTop() const
+{
+    return kGridTop;
+}
+
+int ActivityMapRenderer::gridHeight() const
+{
+    return 7 * (m_cellSize + m_cellSpacing) - m_cellSpacing;
+}
+
+int ActivityMapRenderer::gridRightMargin() const
+{
+    return kGridRightMargin;
+}
+
+int ActivityMapRenderer::columnWidth() const
+{
+    return m_granularity == ActivityGranularity::Week ? kWeekBarWidth : m_cellSize;
+}
+
+int ActivityMapRenderer::columnPitch() const
+{
+    return m_granularity == ActivityGranularity::Week ? kWeekBarWidth + kWeekBarSpacing : m_cellSize + m_cellSpacing;
+}
+
+QDate ActivityMapRenderer::bucketStart(int bucket) const
+{
+    switch (m_granularity)
+    {
+    case ActivityGranularity::Week:
+        return m_firstBucketDate.addDays(7 * qint64(bucket));
+    case ActivityGranularity::Month:
+        return m_firstBucketDate.addMonths(bucket);
+    case ActivityGranularity::Day:
+    default:
+        return m_firstBucketDate.addDays(bucket);
+    }
+}
+
+int ActivityMapRenderer::bucketForDate(const QDate& date) const
+{
+    switch (m_granularity)
+    {
+    case ActivityGranularity::Week:
+        return int(m_firstBucketDate.daysTo(date) / 7);
+    case ActivityGranularity::Month:
+        return (date.year() - m_firstBucketDate.year()) * 12 + date.month() - m_firstBucketDate.month();
+    case ActivityGranularity::Day:
+    default:
+        return int(m_firstBucketDate.daysTo(date));
+    }
+}
+
+int ActivityMapRenderer::columnOfBucket(int bucket) const
+{
+    return m_granularity == ActivityGranularity::Day ? bucket / 7 : bucket;
+}
+
+int ActivityMapRenderer::firstBucketOfColumn(int column) const
+{
+    return m_granularity == ActivityGranularity::Day ? column * 7 : column;
+}
+
+int ActivityMapRenderer::lastBucketOfColumn(int column) const
+{
+    int last = m_granularity == ActivityGranularity::Day ? column * 7 + 6 : column;
+    return qMin(last, m_bucketCount - 1);
+}
+
+QRect ActivityMapRenderer::cellRect(int bucket) const
+{
+    int x = kGridLeft + (columnOfBucket(bucket) - m_firstColumn) * columnPitch();
+
+    // Weekly and monthly buckets are full-height bars
+    if (m_granularity != ActivityGranularity::Day)
+    {
+        return QRect(x, kGridTop, columnWidth(), gridHeight());
+    }
+
+    // Columns are 7-day blocks from the start date, rows are weekdays (Monday on top)
+    int row = (m_startDate.dayOfWeek() - 1 + bucket) % 7;
+    return QRect(x, kGridTop + row * (m_cellSize + m_cellSpacing), m_cellSize, m_cellSize);
+}
+
+int ActivityMapRenderer::bucketAt(const QPoint& pos) const
+{
+    int x = pos.x() - kGridLeft;
+    int y = pos.y() - kGridTop;
+    int pitch = columnPitch();
+    if (x < 0 || y < 0 || x % pitch >= columnWidth() || y >= gridHeight())
+    {
+        return -1; // Outside the grid or in the gap between columns
+    }
+
+    int visibleColumn = x / pitch;
+    int column = m_firstColumn + visibleColumn;
+    if (visibleColumn >= m_visibleColumns || column >= m_columnCount)
+    {
+        return -1;
+    }
+
+    if (m_granularity != ActivityGranularity::Day)
+    {
+        return column;
+    }
+
+    int rowPitch = m_cellSize + m_cellSpacing;
+    if (y % rowPitch >= m_cellSize)
+    {
+        return -1;
+    }
+
+    // Within a column the day whose weekday matches the row
+    int row = y / rowPitch;
+    int startRow = m_startDate.dayOfWeek() - 1;
+    int bucket = column * 7 + (row - startRow + 7) % 7;
+    return bucket < m_bucketCount ? bucket : -1;
+}
+
+QRect ActivityMapRenderer::legendRect(const QSize& size) const
+{
+    // Anchored to the bottom-right corner
+    return QRect(size.width() - 240, size.height() - 40, 200, 30);
+}
+
+QString ActivityMapRenderer::toolTipFor(int bucket) const
+{
+    QDate start = bucketStart(bucket);
+    QString period;
+    switch (m_granularity)
+    {
+    case ActivityGranularity::Week:
+        period = "Week of " + qMax(start, m_startDate).toString("MMM d, yyyy");
+        break;
+    case ActivityGranularity::Month:
+        period = start.toString("MMMM yyyy");
+        break;
+    case ActivityGranularity::Day:
+    default:
+        period = start.toString("MMM d, yyyy");
+        break;
+    }
+
+    if (pomodorosAt(bucket) < 0)
+    {
+        return period + "\nLoading...";
+    }
+
+    return QString("%1\n%2 pomodoros\n%3 minutes")
+           .arg(period)
+           .arg(pomodorosAt(bucket))
+           .arg(minutesAt(bucket));
+}
+
+void ActivityMapRenderer::draw(QPainter& painter, const QSize& size, const QFont& font, const QColor& textColor) const
+{
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(textColor);
+
+    if (m_columnCount > 0)
+    {
+        drawLabels(painter, font);
+
+        // Draw the cells of the visible columns only
+        int lastBucket = lastBucketOfColumn(lastVisibleColumn());
+        for (int bucket = firstBucketOfColumn(m_firstColumn); bucket <= lastBucket; bucket++)
+        {
+            drawCell(painter, bucket);
+        }
+    }
+
+    // Draw the legend
+    painter.setPen(textColor);
+    drawLegend(painter, size);
+}
+
+void ActivityMapRenderer::drawLabels(QPainter& painter, const QFont& font) const
+{
+    // Month labels (year labels for monthly bars) at the column of their first day in range
+    QFont monthFont = font;
+    monthFont.setPointSize(9);
+    painter.setFont(monthFont);
+
+    int monthLabelY = 15;
+    QDate firstDate = qMax(bucketStart(firstBucketOfColumn(m_firstColumn)), m_startDate);
+    QDate lastDate = qMin(bucketStart(lastBucketOfColumn(lastVisibleColumn()) + 1).addDays(-1), m_endDate);
+
+    for (QDate month(firstDate.year(), firstDate.month(), 1); month <= lastDate; month = month.addMonths(1))
+    {
+        bool monthly = m_granularity == ActivityGranularity::Month;
+        if (monthly && month.month() != 1 && month > firstDate)
+        {
+            continue;
+        }
+
+        int column = columnOfBucket(bucketForDate(qMax(month, firstDate)));
+        int x = kGridLeft + (column - m_firstColumn) * columnPitch();
+
+        QString label = monthly
+                            ? QString::number(month.year())
+                            : m_locale.monthName(month.month(), QLocale::ShortFormat);
+        painter.drawText(x, monthLabelY, label);
+    }
+
+    // Weekday labels only make sense for daily cells
+    if (m_granularity != ActivityGranularity::Day)
+    {
+        return;
+    }
+
+    QFont dayFont = font;
+    dayFont.setPointSize(8);
+    painter.setFont(dayFont);
+
+    QStringList dayNames = {"Mon", "Wed", "Fri"};
+    for (int i = 0; i < dayNames.size(); i++)
+    {
+        int dayIndex = i * 2; // 0, 2, 4 for Mon, Wed, Fri
+        int y = kGridTop + dayIndex * (m_cellSize + m_cellSpacing) + m_cellSize / 2;
+        painter.drawText(15, y + 4, dayNames[i]);
+    }
+}
+
+void ActivityMapRenderer::drawCell(QPainter& painter, int bucket) const
+{
+    int count = pomodorosAt(bucket);
+    if (count < 0)
+    {
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(skeletonColor());
+    }
+    else
+    {
+        const QColor& cellColor = colorForCount(count);
+        painter.setPen(QPen(cellColor.darker(110), 1));
+        painter.setBrush(cellColor);
+    }
+    painter.drawRoundedRect(cellRect(bucket), 2, 2);
+}
+
+QColor ActivityMapRenderer::skeletonColor()
+{
+    // Placeholder for cells whose data is still loading
+    return QColor(238, 238, 238, 110);
+}
+
+QSize ActivityMapRenderer::fullSize() const
+{
+    int width = kGridLeft + m_columnCount * columnPitch() + kGridRightMargin;
+    return QSize(qMax(kMinimumWidth, width), kGridTop + gridHeight() + kLegendHeight);
+}
+
+ActivityMapRenderer ActivityMapRenderer::showingAllColumns() const
+{
+    ActivityMapRenderer renderer = *this;
+    renderer.setViewport(0, fullSize().width());
+    return renderer;
+}
+
+QImage ActivityMapRenderer::renderImage(const QFont& font, const QColor& textColor, const QColor& background,
+                                        qreal devicePixelRatio) const
+{
+    ActivityMapRenderer renderer = showingAllColumns();
+    QSize size = fullSize();
+
+    QImage image(size * devicePixelRatio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(devicePixelRatio);
+    image.fill(background);
+
+    QPainter painter(&image);
+    renderer.draw(painter, size, font, textColor);
+    painter.end();
+
+    return image;
+}
+
+bool ActivityMapRenderer::renderSvg(const QString& filePath, const QFont& font, const QColor& textColor,
+                                    const QColor& background) const
+{
+#ifdef HAVE_QT_SVG
+    ActivityMapRenderer renderer = showingAllColumns();
+    QSize size = fullSize();
+
+    QSvgGenerator generator;
+    generator.setFileName(filePath);
+    generator.setSize(size);
+    generator.setViewBox(QRect(QPoint(0, 0), size));
+    generator.setTitle("Pomodoro activity");
+
+    QPainter painter;
+    if (!painter.begin(&generator))
+    {
+        return false;
+    }
+    painter.fillRect(QRect(QPoint(0, 0), size), background);
+    renderer.draw(painter, size, font, textColor);
+    return painter.end();
+#else
+    Q_UNUSED(filePath);
+    Q_UNUSED(font);
+    Q_UNUSED(textColor);
+    Q_UNUSED(background);
+    return false;
+#endif
+}
+
+void ActivityMapRenderer::buildColorTable()
+{
+    // Every count in range gets its colour once instead of per cell per paint
+    m_colorTable.resize(m_maxPomodoros + 1);
+    for (int count = 0; count <= m_maxPomodoros; count++)
+    {
+        m_colorTable[count] = getColorForCount(count);
+    }
+}
+
+const QColor& ActivityMapRenderer::colorForCount(int count) const
+{
+    return m_colorTable[qBound(0, count, m_maxPomodoros)];
+}
+
+QColor ActivityMapRenderer::getColorForCount(int count) const
+{
+    if (count == 0)
+    {
+        return QColor(238, 238, 238); // Light gray for zero
+    }
+
+    // Set a minimum intensity level for non-zero values
+    // This ensures even small counts have a visible color
+    int minIntensity = 50; // Adjust this value as needed (0-255)
+
+    // Calculate intensity with a minimum threshold
+    int intensity = minIntensity;
+    if (m_maxPomodoros > 1)
+    {
+        // Scale the remaining intensity range (minIntensity to 255)
+        int scaledIntensity = (count * (255 - minIntensity)) / m_maxPomodoros;
+        intensity += scaledIntensity;
+    }
+
+    // Ensure intensity is within bounds
+    intensity = qMin(255, qMax(minIntensity, intensity));
+
+    // GitHub-like green scale with minimum visibility
+    return QColor(
+        235 - (intensity * 0.8), // Decrease red as count increases
+        235 - (intensity * 0.3) + 20, // Keep green higher
+        235 - (intensity * 0.8) // Decrease blue as count increases
+    );
+}
+
+void ActivityMapRenderer::drawLegend(QPainter& painter, const QSize& size) const
+{
+    int legendX = size.width() - 240;
+    int legendY = size.height() - 40;
+    int legendItemWidth = 15;
+    int legendSpacing = 5;
+
+    painter.drawText(legendX, legendY + 12, "Less");
+
+    legendX += 40;
+
+    // Draw 5 sample boxes representing activity levels
+    for (int i = 0; i < 5; i++)
+    {
+        int value = i * m_maxPomodoros / 4;
+        const QColor& color = colorForCount(value);
+
+        QRect rect(legendX + i * (legendItemWidth + legendSpacing),
+                   legendY, legendItemWidth, legendItemWidth);
+
+        painter.setBrush(color);
+        painter.setPen(QPen(color.darker(110), 1));
+        painter.drawRoundedRect(rect, 2, 2);
+    }
+
+    legendX += 5 * (legendItemWidth + legendSpacing) + 5;
+    painter.drawText(legendX, legendY + 12, "More");
+}
@@ -0,0 +1,126 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_ACTIVITYMAPRENDERER_H
+#define ZIGA_POMODORO_ACTIVITYMAPRENDERER_H
+
+#include <QDate>
+#include <QVector>
+#include <QColor>
+#include <QFont>
+#include <QImage>
+#include <QLocale>
+#include <QRect>
+
+#include "databasemanager.h" // ActivityGranularity
+
+class QPainter;
+
+// Layout and drawing of the activity heatmap, independent of any widget.
+// PomodoroActivityMap drives it for the visible columns; on its own it
+// renders a whole range to an image or SVG without a display.
+class ActivityMapRenderer
+{
+public:
+    ActivityMapRenderer();
+
+    // Range and level of detail; clears the loaded data
+    void setDateRange(const QDate& startDate, const QDate& endDate, ActivityGranularity granularity);
+    QDate startDate() const;
+    QDate endDate() const;
+    ActivityGranularity granularity() const;
+    int bucketCount() const;
+    int columnCount() const;
+
+    // The finest level whose columns fit in a couple of pages of gridWidth
+    static ActivityGranularity autoGranularity(const QDate& startDate, const QDate& endDate, int gridWidth);
+
+    // Loaded data: buckets [first, first + size), -1 while still loading
+    void setWindow(int first, const QVector<int>& pomodoros, const QVector<int>& seconds);
+    int windowFirst() const;
+    int windowSize() const;
+    void setBucket(int bucket, int pomodoros, int seconds); // Ignored outside the window
+    int pomodorosAt(int bucket) const; // -1 while loading
+    int secondsAt(int bucket) const; // Work time, exact so recorded sessions can be added
+    int minutesAt(int bucket) const;
+
+    // Colour scale top; the table is rebuilt when it changes
+    void setMaximum(int maximum);
+    int maximum() const;
+
+    // Loads every bucket and the maximum in one go, for offscreen use
+    bool loadAll(DatabaseManager* dbManager);
+
+    // Columns shown in a viewport of the given width, starting at firstColumn
+    void setViewport(int firstColumn, int width);
+    int firstColumn() const;
+    int lastVisibleColumn() const;
+    int visibleColumnCount() const;
+    int visibleColumnCount(int width) const;
+
+    void setLocale(const QLocale& locale); // Month names
+
+    // Geometry
+    int gridLeft() const;
+    int gridTop() const;
+    int gridHeight() const;
+    int gridRightMargin() const;
+    int columnWidth() const;
+    int columnPitch() const;
+    QDate bucketStart(int bucket) const;
+    int bucketForDate(const QDate& date) const;
+    int columnOfBucket(int bucket) const;
+    int firstBucketOfColumn(int column) const;
+    int lastBucketOfColumn(int column) const;
+    QRect cellRect(int bucket) const;
+    int bucketAt(const QPoint& pos) const; // Direct from grid coordinates, -1 outside cells
+    QRect legendRect(const QSize& size) const;
+    QString toolTipFor(int bucket) const;
+
+    // Drawing of the visible columns, labels and legend
+    void draw(QPainter& painter, const QSize& size, const QFont& font, const QColor& textColor) const;
+    void drawCell(QPainter& painter, int bucket) const;
+    const QColor& colorForCount(int count) const;
+    static QColor skeletonColor();
+
+    // The whole range at once, with no scrolling
+    QSize fullSize() const;
+    QImage renderImage(const QFont& font, const QColor& textColor, const QColor& background,
+                       qreal devicePixelRatio = 1.0) const;
+    bool renderSvg(const QString& filePath, const QFont& font, const QColor& textColor,
+                   const QColor& background) const; // False when built without QtSvg
+
+private:
+    void buildColorTable();
+    QColor getColorForCount(int count) const; // Scale formula, used to fill the table
+    void drawLabels(QPainter& painter, const QFont& font) const;
+    void drawLegend(QPainter& painter, const QSize& size) const;
+    ActivityMapRenderer showingAllColumns() const;
+
+    QDate m_startDate;
+    QDate m_endDate;
+
+    // One bucket per day, week or month; days are laid out in 7-day columns,
+    // weeks and months as one bar per column
+    ActivityGranularity m_granularity;
+    QDate m_firstBucketDate; // Start of bucket 0
+    int m_bucketCount;
+    int m_columnCount;
+
+    // Loaded window in flat arrays indexed by bucket - m_loadedFirst
+    int m_loadedFirst;
+    QVector<int> m_pomodoros;
+    QVector<int> m_seconds;
+    QVector<QColor> m_colorTable; // Indexed by count, 0..m_maxPomodoros
+
+    int m_firstColumn;
+    int m_visibleColumns;
+    QLocale m_locale;
+
+    int m_cellSize;
+    int m_cellSpacing;
+    int m_maxPomodoros;
+};
+
+#endif // ZIGA_POMODORO_ACTIVITYMAPRENDERER_H
@@ -0,0 +1,193 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "analyticsengine.h"
+#include "databasemanager.h"
+
+namespace
+{
+    // Week-over-week compares two 7-day windows
+    constexpr int kWeekDays = 7;
+}
+
+AnalyticsEngine::AnalyticsEngine(const QVector<int>& windows)
+{
+    // Empty windows would divide by zero
+    for (int window : windows)
+    {
+        if (window > 0)
+        {
+            m_windows.append(window);
+        }
+    }
+}
+
+QVector<int> AnalyticsEngine::windows() const
+{
+    return m_windows;
+}
+
+int AnalyticsEngine::lookbackDays() const
+{
+    int longest = 2 * kWeekDays;
+    for (int window : m_windows)
+    {
+        longest = qMax(longest, window);
+    }
+    return longest - 1;
+}
+
+AnalyticsReport AnalyticsEngine::analyze(DatabaseManager* dbManager, const QDate& from, const QDate& to)
+{
+    if (!from.isValid() || !to.isValid() || from > to)
+    {
+        setSeries(QDate(), QDate(), QDate(), QVector<int>());
+        return report();
+    }
+
+    QDate firstDate = from.addDays(-lookbackDays());
+    QVector<int> pomodoros(int(firstDate.daysTo(to)) + 1, 0);
+
+    // One query for the range and its lookback; days without sessions stay zero
+    if (dbManager && dbManager->isInitialized())
+    {
+        const QList<ActivityBucket> buckets = dbManager->getActivityBuckets(firstDate, to, ActivityGranularity::Day);
+        for (const ActivityBucket& bucket : buckets)
+        {
+            int index = int(firstDate.daysTo(bucket.start));
+            if (index >= 0 && index < pomodoros.size())
+            {
+                pomodoros[index] = bucket.pomodoros;
+            }
+        }
+    }
+
+    setSeries(from, to, firstDate, pomodoros);
+    return report();
+}
+
+void AnalyticsEngine::setSeries(const QDate& from, const QDate& to, const QDate& firstDate,
+                                const QVector<int>& pomodoros)
+{
+    m_from = from;
+    m_to = to;
+    m_firstDate = firstDate;
+    m_pomodoros = pomodoros;
+}
+
+bool AnalyticsEngine::addCompleted(const QDate& date)
+{
+    // Lookback days count towards the windows; days after the range do not exist yet
+    if (!m_firstDate.isValid() || date < m_firstDate || date > m_to)
+    {
+        return false;
+    }
+
+    qint64 index = m_firstDate.daysTo(date);
+    if (index >= m_pomodoros.size())
+    {
+        return false;
+    }
+
+    m_pomodoros[int(index)]++;
+    return true;
+}
+
+AnalyticsReport AnalyticsEngine::report() const
+{
+    AnalyticsReport report;
+    report.from = m_from;
+    report.to = m_to;
+
+    const int count = m_pomodoros.size();
+    const int rangeStart = m_firstDate.isValid() ? int(m_firstDate.daysTo(m_from)) : count;
+    if (rangeStart < 0 || rangeStart >= count)
+    {
+        return report;
+    }
+
+    const int windowCount = m_windows.size();
+    report.averages.resize(windowCount);
+    for (int k = 0; k < windowCount; k++)
+    {
+        report.averages[k].days = m_windows[k];
+        report.averages[k].values.resize(count - rangeStart);
+    }
+
+    QVector<qint64> sums(windowCount, 0);
+    qint64 weekSum = 0;
+    int weekdaySums[kWeekDays] = {};
+    int weekdayDays[kWeekDays] = {};
+    int weekday = m_firstDate.dayOfWeek() - 1;
+
+    // One pass: each window's sum gains today and drops the day that left it
+    for (int i = 0; i < count; i++)
+    {
+        const int value = m_pomodoros[i];
+
+        for (int k = 0; k < windowCount; k++)
+        {
+            const int window = m_windows[k];
+            sums[k] += value;
+            if (i >= window)
+            {
+                sums[k] -= m_pomodoros[i - window];
+            }
+        }
+
+        weekSum += value;
+        if (i >= kWeekDays)
+        {
+            weekSum -= m_pomodoros[i - kWeekDays];
+        }
+
+        if (i >= rangeStart)
+        {
+            for (int k = 0; k < windowCount; k++)
+            {
+                report.averages[k].values[i - rangeStart] = double(sums[k]) / qMin(m_windows[k], i + 1);
+            }
+
+            weekdaySums[weekday] += value;
+            weekdayDays[weekday]++;
+        }
+
+        // The 7 days ending a week before the last day
+        if (i == count - 1 - kWeekDays)
+        {
+            report.lastWeek = int(weekSum);
+        }
+
+        weekday = (weekday + 1) % kWeekDays;
+    }
+
+    for (RollingAverage& average : report.averages)
+    {
+        average.latest = average.values.last();
+    }
+
+    report.thisWeek = int(weekSum);
+    report.weekOverWeek = report.lastWeek > 0 ? double(report.thisWeek - report.lastWeek) / report.lastWeek : 0.0;
+
+    // Only weekdays that occur in the range take part
+    for (int day = 0; day < kWeekDays; day++)
+    {
+        if (weekdayDays[day] == 0)
+        {
+            continue;
+        }
+
+        report.weekdayAverage[day] = double(weekdaySums[day]) / weekdayDays[day];
+        if (report.bestWeekday == 0 || report.weekdayAverage[day] > report.weekdayAverage[report.bestWeekday - 1])
+        {
+            report.bestWeekday = day + 1;
+        }
+        if (report.worstWeekday == 0 || report.weekdayAverage[day] < report.weekdayAverage[report.worstWeekday - 1])
+        {
+            report.worstWeekday = day + 1;
+        }
+    }
+
+    return report;
+}
@@ -0,0 +1,68 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_ANALYTICSENGINE_H
+#define ZIGA_POMODORO_ANALYTICSENGINE_H
+
+#include <QDate>
+#include <QVector>
+
+class DatabaseManager;
+
+// Trailing mean of completed pomodoros per day over a fixed number of days
+struct RollingAverage
+{
+    int days = 0;
+    QVector<double> values; // One per day of the range, for the window ending on that day
+    double latest = 0.0; // Window ending on the last day
+};
+
+// Everything AnalyticsEngine derives for a date range
+struct AnalyticsReport
+{
+    QDate from;
+    QDate to;
+    QVector<RollingAverage> averages; // One per configured window, in order
+
+    // Completed pomodoros in the 7 days ending on `to` and the 7 before
+    int thisWeek = 0;
+    int lastWeek = 0;
+    double weekOverWeek = 0.0; // Relative change, 0.25 = +25%; 0 when lastWeek is 0
+
+    // Mean pomodoros per weekday within the range, index 0 = Monday
+    double weekdayAverage[7] = {};
+    int bestWeekday = 0; // Qt::DayOfWeek, 0 when the range is empty
+    int worstWeekday = 0;
+};
+
+// Rolling statistics over a dense per-day series of completed pomodoros.
+// The series is read with one query, reaching back far enough to fill the
+// longest window on the first day of the range; every metric then comes out
+// of a single pass with one sliding sum per window. Recorded sessions can be
+// added afterwards without touching the database.
+class AnalyticsEngine
+{
+public:
+    explicit AnalyticsEngine(const QVector<int>& windows = {7, 30});
+
+    QVector<int> windows() const;
+
+    // Loads the range and computes the report in one call
+    AnalyticsReport analyze(DatabaseManager* dbManager, const QDate& from, const QDate& to);
+
+    void setSeries(const QDate& from, const QDate& to, const QDate& firstDate, const QVector<int>& pomodoros);
+    bool addCompleted(const QDate& date); // False, and ignored, outside the loaded series
+    AnalyticsReport report() const;
+
+    int lookbackDays() const; // Days before the range the series must start
+
+private:
+    QVector<int> m_windows;
+    QDate m_from;
+    QDate m_to;
+    QDate m_firstDate; // Day of m_pomodoros[0]
+    QVector<int> m_pomodoros;
+};
+
+#endif // ZIGA_POMODORO_ANALYTICSENGINE_H
@@ -0,0 +1,160 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "clock.h"
+
+namespace
+{
+    Clock* s_instance = nullptr;
+}
+
+Clock::Clock(QObject* parent)
+    : QObject(parent)
+{
+}
+
+Clock::~Clock()
+{
+    if (s_instance == this)
+    {
+        s_instance = nullptr;
+    }
+}
+
+QDate Clock::currentDate() const
+{
+    return currentDateTime().date();
+}
+
+bool Clock::isSimulated() const
+{
+    return false;
+}
+
+Clock* Clock::instance()
+{
+    if (!s_instance)
+    {
+        // Lives for the whole process
+        static SystemClock systemClock;
+        s_instance = &systemClock;
+    }
+    return s_instance;
+}
+
+void Clock::setInstance(Clock* clock)
+{
+    s_instance = clock;
+}
+
+SystemClock::SystemClock(QObject* parent)
+    : Clock(parent)
+{
+    m_monotonic.start();
+}
+
+qint64 SystemClock::monotonicMs() const
+{
+    return m_monotonic.elapsed();
+}
+
+QDateTime SystemClock::currentDateTime() const
+{
+    return QDateTime::currentDateTime();
+}
+
+SimulatedClock::SimulatedClock(const QDateTime& start, QObject* parent)
+    : Clock(parent)
+      , m_start(start)
+      , m_nowMs(0)
+      , m_nextId(1)
+{
+}
+
+qint64 SimulatedClock::monotonicMs() const
+{
+    return m_nowMs;
+}
+
+QDateTime SimulatedClock::currentDateTime() const
+{
+    return m_start.addMSecs(m_nowMs);
+}
+
+bool SimulatedClock::isSimulated() const
+{
+    return true;
+}
+
+SimulatedClock::WakeupId SimulatedClock::scheduleWakeup(qint64 deadlineMs, std::function<void()> callback)
+{
+    WakeupId id = m_nextId++;
+    qint64 deadline = qMax(deadlineMs, m_nowMs);
+
+    m_wakeups.emplace(WakeupKey(deadline, id), std::move(callback));
+    m_deadlines.insert(id, deadline);
+    return id;
+}
+
+void SimulatedClock::cancelWakeup(WakeupId id)
+{
+    auto it = m_deadlines.find(id);
+    if (it == m_deadlines.end())
+    {
+        return;
+    }
+
+    m_wakeups.erase(WakeupKey(it.value(), id));
+    m_deadlines.erase(it);
+}
+
+bool SimulatedClock::hasPendingWakeups() const
+{
+    return !m_wakeups.empty();
+}
+
+qint64 SimulatedClock::nextWakeupMs() const
+{
+    return m_wakeups.empty() ? -1 : m_wakeups.begin()->first.first;
+}
+
+void SimulatedClock::advanceBy(qint64 ms)
+{
+    advanceTo(m_nowMs + ms);
+}
+
+void SimulatedClock::advanceTo(qint64 ms)
+{
+    while (!m_wakeups.empty() && m_wakeups.begin()->first.first <= ms)
+    {
+        runNextWakeup();
+    }
+
+    m_nowMs = qMax(m_nowMs, ms);
+}
+
+void SimulatedClock::advanceTo(const QDateTime& dateTime)
+{
+    advanceTo(m_start.msecsTo(dateTime));
+}
+
+bool SimulatedClock::runNextWakeup()
+{
+    if (m_wakeups.empty())
+    {
+        return false;
+    }
+
+    auto it = m_wakeups.begin();
+    WakeupId id = it->first.second;
+    std::function<void()> callback = std::move(it->second);
+
+    m_nowMs = qMax(m_nowMs, it->first.first);
+    m_wakeups.erase(it);
+    m_deadlines.remove(id);
+
+    // The callback may schedule or cancel further wakeups
+    callback();
+    return true;
+}
@@ -0,0 +1,91 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_CLOCK_H
+#define ZIGA_POMODORO_CLOCK_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <functional>
+#include <map>
+
+// Source of time for the timer engine, session recording and statistics.
+// The system clock is used unless a simulated one is installed.
+class Clock : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit Clock(QObject* parent = nullptr);
+    ~Clock() override;
+
+    // Monotonic milliseconds, used for deadlines
+    virtual qint64 monotonicMs() const = 0;
+
+    // Wall-clock time, used for recorded sessions and date ranges
+    virtual QDateTime currentDateTime() const = 0;
+    QDate currentDate() const;
+
+    virtual bool isSimulated() const;
+
+    // Process-wide clock
+    static Clock* instance();
+    static void setInstance(Clock* clock);
+};
+
+class SystemClock : public Clock
+{
+    Q_OBJECT
+
+public:
+    explicit SystemClock(QObject* parent = nullptr);
+
+    qint64 monotonicMs() const override;
+    QDateTime currentDateTime() const override;
+
+private:
+    QElapsedTimer m_monotonic;
+};
+
+// Clock that only moves when told to. Timers arm wakeups on it instead of
+// on QTimer, so whole days of sessions can be played through in a loop.
+class SimulatedClock : public Clock
+{
+    Q_OBJECT
+
+public:
+    using WakeupId = quint64;
+
+    explicit SimulatedClock(const QDateTime& start, QObject* parent = nullptr);
+
+    qint64 monotonicMs() const override;
+    QDateTime currentDateTime() const override;
+    bool isSimulated() const override;
+
+    WakeupId scheduleWakeup(qint64 deadlineMs, std::function<void()> callback);
+    void cancelWakeup(WakeupId id);
+    bool hasPendingWakeups() const;
+    qint64 nextWakeupMs() const;
+
+    // Moves time forward, firing due wakeups in deadline order
+    void advanceBy(qint64 ms);
+    void advanceTo(qint64 ms);
+    void advanceTo(const QDateTime& dateTime);
+
+    // Jumps straight to the next wakeup and fires it
+    bool runNextWakeup();
+
+private:
+    using WakeupKey = std::pair<qint64, WakeupId>;
+
+    QDateTime m_start;
+    qint64 m_nowMs;
+    WakeupId m_nextId;
+    std::map<WakeupKey, std::function<void()>> m_wakeups;
+    QHash<WakeupId, qint64> m_deadlines;
+};
+
+#endif // ZIGA_POMODORO_CLOCK_H
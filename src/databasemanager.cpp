@@ -3,6 +3,7 @@
 //
 
 #include "databasemanager.h"
+#include "trace.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QFile>
@@ -12,9 +13,18 @@
 #include <QVariant>
 #include <QDebug>
 
+namespace
+{
+    // 2: session_events table, paused_seconds and interruptions columns
+    // 3: timeline blob per session
+    constexpr int kSchemaVersion = 3;
+}
+
 DatabaseManager::DatabaseManager(QObject* parent)
     : QObject(parent)
       , m_initialized(false)
+      , m_readOnly(false)
+      , m_inBatch(false)
 {
 }
 
@@ -24,6 +34,29 @@ DatabaseManager::~DatabaseManager()
     {
         m_db.close();
     }
+
+    // Drop the connection as well, so the name can be used again without warnings
+    if (m_db.isValid())
+    {
+        QString connectionName = m_db.connectionName();
+        m_db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(connectionName);
+    }
+}
+
+void DatabaseManager::setDatabasePath(const QString& path)
+{
+    m_databasePath = path;
+}
+
+void DatabaseManager::setConnectionName(const QString& name)
+{
+    m_connectionName = name;
+}
+
+void DatabaseManager::setReadOnly(bool readOnly)
+{
+    m_readOnly = readOnly;
 }
 
 bool DatabaseManager::initialize()
@@ -34,8 +67,14 @@ bool DatabaseManager::initialize()
     }
 
     // Set up database connection
-    m_db = QSqlDatabase::addDatabase("QSQLITE");
+    m_db = m_connectionName.isEmpty()
+               ? QSqlDatabase::addDatabase("QSQLITE")
+               : QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
     m_db.setDatabaseName(getDatabasePath());
+    if (m_readOnly)
+    {
+        m_db.setConnectOptions("QSQLITE_OPEN_READONLY");
+    }
 
     if (!m_db.open())
     {
@@ -43,6 +82,20 @@ bool DatabaseManager::initialize()
         return false;
     }
 
+    // Read-only connections take the schema as they find it
+    if (m_readOnly)
+    {
+        if (getCurrentSchemaVersion() == 0)
+        {
+            emit databaseError("Not a pomodoro database: " + getDatabasePath());
+            m_db.close();
+            return false;
+        }
+
+        m_initialized = true;
+        return true;
+    }
+
     // Check if we need to create tables or upgrade schema
     int currentVersion = getCurrentSchemaVersion();
     if (currentVersion == 0)
@@ -53,10 +106,9 @@ bool DatabaseManager::initialize()
             return false;
         }
     }
-    else if (currentVersion < 1)
+    else if (currentVersion < kSchemaVersion)
     {
-        // For future upgrades
-        if (!upgradeSchema(currentVersion, 1))
+        if (!upgradeSchema(currentVersion, kSchemaVersion))
         {
             m_db.close();
             return false;
@@ -72,46 +124,215 @@ bool DatabaseManager::isInitialized() const
     return m_initialized;
 }
 
-bool DatabaseManager::recordPomodoroSession(const QDateTime& startTime, int durationSeconds, bool completed)
+bool DatabaseManager::beginBatch()
+{
+    ZP_TRACE_SCOPE("db", "DatabaseManager::beginBatch");
+
+    // Batches do not nest; the open one keeps going
+    if (m_inBatch)
+    {
+        return false;
+    }
+
+    m_inBatch = m_initialized && m_db.transaction();
+    return m_inBatch;
+}
+
+bool DatabaseManager::commitBatch()
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::commitBatch");
+
+    if (!m_initialized || !m_inBatch)
+    {
+        return false;
+    }
+
+    if (!m_db.commit())
+    {
+        // None of the batched writes happened, so none are announced
+        QString error = m_db.lastError().text();
+        m_db.rollback();
+        m_inBatch = false;
+        m_pendingSessions.clear();
+        emit databaseError("Failed to commit batch: " + error);
+        return false;
+    }
+
+    // Only now are the batched sessions visible to other readers
+    m_inBatch = false;
+    const QVector<RecordedSession> sessions = m_pendingSessions;
+    m_pendingSessions.clear();
+    for (const RecordedSession& session : sessions)
+    {
+        emit sessionRecorded(session);
+    }
+
+    return true;
+}
+
+void DatabaseManager::notifyRecorded(const RecordedSession& session)
+{
+    if (m_inBatch)
+    {
+        m_pendingSessions.append(session);
+    }
+    else
+    {
+        emit sessionRecorded(session);
+    }
+}
+
+bool DatabaseManager::recordPomodoroSession(const QDateTime& startTime, int durationSeconds, bool completed,
+                                            int pausedSeconds, int interruptions, const QByteArray& timeline)
+{
+    ZP_TRACE_SCOPE("db", "DatabaseManager::recordPomodoroSession");
+
     if (!m_initialized)
     {
         emit databaseError("Database not initialized");
         return false;
     }
 
-    QString queryStr = "INSERT INTO pomodoro_sessions (start_time, duration_seconds, completed) "
-        "VALUES (:start_time, :duration, :completed)";
+    QString queryStr = "INSERT INTO pomodoro_sessions "
+        "(start_time, duration_seconds, completed, paused_seconds, interruptions, timeline) "
+        "VALUES (:start_time, :duration, :completed, :paused, :interruptions, :timeline)";
 
     QMap<QString, QVariant> bindValues;
     bindValues[":start_time"] = startTime;
     bindValues[":duration"] = durationSeconds;
     bindValues[":completed"] = completed ? 1 : 0;
+    bindValues[":paused"] = pausedSeconds;
+    bindValues[":interruptions"] = interruptions;
+    bindValues[":timeline"] = timeline;
+
+    if (!executeSqlQuery(queryStr, bindValues))
+    {
+        return false;
+    }
 
-    return executeSqlQuery(queryStr, bindValues);
+    RecordedSession session;
+    session.record = {startTime, durationSeconds, pausedSeconds, interruptions, completed, timeline};
+    notifyRecorded(session);
+    return true;
 }
 
-bool DatabaseManager::recordBreakSession(const QDateTime& startTime, int durationSeconds, bool isLongBreak)
+bool DatabaseManager::recordBreakSession(const QDateTime& startTime, int durationSeconds, bool isLongBreak,
+                                         int pausedSeconds, int interruptions, const QByteArray& timeline)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::recordBreakSession");
+
     if (!m_initialized)
     {
         emit databaseError("Database not initialized");
         return false;
     }
 
-    QString queryStr = "INSERT INTO break_sessions (start_time, duration_seconds, is_long_break) "
-        "VALUES (:start_time, :duration, :is_long_break)";
+    QString queryStr = "INSERT INTO break_sessions "
+        "(start_time, duration_seconds, is_long_break, paused_seconds, interruptions, timeline) "
+        "VALUES (:start_time, :duration, :is_long_break, :paused, :interruptions, :timeline)";
 
     QMap<QString, QVariant> bindValues;
     bindValues[":start_time"] = startTime;
     bindValues[":duration"] = durationSeconds;
     bindValues[":is_long_break"] = isLongBreak ? 1 : 0;
+    bindValues[":paused"] = pausedSeconds;
+    bindValues[":interruptions"] = interruptions;
+    bindValues[":timeline"] = timeline;
+
+    if (!executeSqlQuery(queryStr, bindValues))
+    {
+        return false;
+    }
+
+    RecordedSession session;
+    session.kind = isLongBreak ? RecordedSession::Kind::LongBreak : RecordedSession::Kind::ShortBreak;
+    session.record = {startTime, durationSeconds, pausedSeconds, interruptions, true, timeline};
+    notifyRecorded(session);
+    return true;
+}
+
+bool DatabaseManager::appendSessionEvents(const QVector<SessionEvent>& events)
+{
+    ZP_TRACE_SCOPE("db", "DatabaseManager::appendSessionEvents");
+
+    if (!m_initialized)
+    {
+        emit databaseError("Database not initialized");
+        return false;
+    }
+
+    // Join an open batch if there is one, otherwise use our own transaction
+    bool ownTransaction = !m_inBatch;
+    if (ownTransaction && !m_db.transaction())
+    {
+        emit databaseError("Failed to begin transaction: " + m_db.lastError().text());
+        return false;
+    }
+
+    QSqlQuery query(m_db);
+    query.prepare("INSERT INTO session_events (time_ms, type, mode) VALUES (?, ?, ?)");
+
+    for (const SessionEvent& event : events)
+    {
+        query.bindValue(0, event.epochMs);
+        query.bindValue(1, static_cast<int>(event.type));
+        query.bindValue(2, static_cast<int>(event.mode));
+
+        if (!query.exec())
+        {
+            if (ownTransaction)
+            {
+                m_db.rollback();
+            }
+            emit databaseError("Failed to append session events: " + query.lastError().text());
+            return false;
+        }
+    }
 
-    return executeSqlQuery(queryStr, bindValues);
+    return !ownTransaction || m_db.commit();
+}
+
+QVector<SessionEvent> DatabaseManager::getSessionEvents(qint64 fromMs, qint64 toMs)
+{
+    ZP_TRACE_SCOPE("db", "DatabaseManager::getSessionEvents");
+
+    QVector<SessionEvent> events;
+
+    if (!m_initialized)
+    {
+        emit databaseError("Database not initialized");
+        return events;
+    }
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT time_ms, type, mode FROM session_events "
+        "WHERE time_ms >= :from_ms AND time_ms < :to_ms ORDER BY time_ms, id");
+    query.bindValue(":from_ms", fromMs);
+    query.bindValue(":to_ms", toMs);
+
+    if (!query.exec())
+    {
+        emit databaseError("Failed to get session events: " + query.lastError().text());
+        return events;
+    }
+
+    while (query.next())
+    {
+        SessionEvent event;
+        event.epochMs = query.value(0).toLongLong();
+        event.type = static_cast<SessionEvent::Type>(query.value(1).toInt());
+        event.mode = static_cast<SessionMode>(query.value(2).toInt());
+        events.append(event);
+    }
+
+    return events;
 }
 
 int DatabaseManager::getTotalCompletedPomodoros(const QDate& date)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::getTotalCompletedPomodoros");
+
     if (!m_initialized)
     {
         emit databaseError("Database not initialized");
@@ -136,6 +357,8 @@ int DatabaseManager::getTotalCompletedPomodoros(const QDate& date)
 
 int DatabaseManager::getTotalWorkMinutes(const QDate& date)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::getTotalWorkMinutes");
+
     if (!m_initialized)
     {
         emit databaseError("Database not initialized");
@@ -160,6 +383,8 @@ int DatabaseManager::getTotalWorkMinutes(const QDate& date)
 
 double DatabaseManager::getAverageSessionLength(const QDate& from, const QDate& to)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::getAverageSessionLength");
+
     if (!m_initialized)
     {
         emit databaseError("Database not initialized");
@@ -183,8 +408,146 @@ double DatabaseManager::getAverageSessionLength(const QDate& from, const QDate&
     return query.value(0).toDouble();
 }
 
+QList<SessionTimelineRecord> DatabaseManager::getSessionTimelines(const QDate& from, const QDate& to)
+{
+    ZP_TRACE_SCOPE("db", "DatabaseManager::getSessionTimelines");
+
+    QList<SessionTimelineRecord> results;
+
+    if (!m_initialized)
+    {
+        emit databaseError("Database not initialized");
+        return results;
+    }
+
+    QString queryStr = "SELECT start_time, duration_seconds, paused_seconds, interruptions, completed, timeline "
+        "FROM pomodoro_sessions "
+        "WHERE date(start_time) BETWEEN date(:from) AND date(:to) "
+        "ORDER BY start_time";
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(queryStr);
+    query.bindValue(":from", from.toString(Qt::ISODate));
+    query.bindValue(":to", to.toString(Qt::ISODate));
+
+    if (!query.exec())
+    {
+        emit databaseError("Failed to get session timelines: " + query.lastError().text());
+        return results;
+    }
+
+    while (query.next())
+    {
+        SessionTimelineRecord record;
+        record.startTime = query.value(0).toDateTime();
+        record.durationSeconds = query.value(1).toInt();
+        record.pausedSeconds = query.value(2).toInt();
+        record.interruptions = query.value(3).toInt();
+        record.completed = query.value(4).toBool();
+        record.timeline = query.value(5).toByteArray();
+        results.append(record);
+    }
+
+    return results;
+}
+
+namespace
+{
+// SQL expression yielding the ISO date a session's bucket starts on
+QString bucketExpression(ActivityGranularity granularity)
+{
+    switch (granularity)
+    {
+    case ActivityGranularity::Week:
+        return "date(start_time, 'weekday 0', '-6 days')"; // Monday of its week
+    case ActivityGranularity::Month:
+        return "strftime('%Y-%m-01', start_time)";
+    case ActivityGranularity::Day:
+    default:
+        return "date(start_time)";
+    }
+}
+}
+
+QList<ActivityBucket> DatabaseManager::getActivityBuckets(const QDate& from, const QDate& to,
+                                                          ActivityGranularity granularity)
+{
+    ZP_TRACE_SCOPE("db", "DatabaseManager::getActivityBuckets");
+
+    QList<ActivityBucket> results;
+
+    if (!m_initialized)
+    {
+        emit databaseError("Database not initialized");
+        return results;
+    }
+
+    QString queryStr = "SELECT " + bucketExpression(granularity) + " AS bucket, "
+        "SUM(completed = 1), SUM(duration_seconds) "
+        "FROM pomodoro_sessions "
+        "WHERE start_time >= :from AND start_time < :until " // Bare column, so idx_pomodoro_start_time applies
+        "GROUP BY bucket ORDER BY bucket";
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare(queryStr);
+    query.bindValue(":from", from.toString(Qt::ISODate));
+    query.bindValue(":until", to.addDays(1).toString(Qt::ISODate)); // ISO timestamps sort as text
+
+    if (!query.exec())
+    {
+        emit databaseError("Failed to get activity buckets: " + query.lastError().text());
+        return results;
+    }
+
+    while (query.next())
+    {
+        ActivityBucket bucket;
+        bucket.start = QDate::fromString(query.value(0).toString(), Qt::ISODate);
+        bucket.pomodoros = query.value(1).toInt();
+        bucket.seconds = query.value(2).toInt();
+        bucket.minutes = bucket.seconds / 60;
+        results.append(bucket);
+    }
+
+    return results;
+}
+
+int DatabaseManager::getMaxActivityBucket(const QDate& from, const QDate& to, ActivityGranularity granularity)
+{
+    ZP_TRACE_SCOPE("db", "DatabaseManager::getMaxActivityBucket");
+
+    if (!m_initialized)
+    {
+        emit databaseError("Database not initialized");
+        return 0;
+    }
+
+    QString queryStr = "SELECT MAX(count) FROM ("
+        "SELECT " + bucketExpression(granularity) + " AS bucket, COUNT(*) AS count "
+        "FROM pomodoro_sessions "
+        "WHERE start_time >= :from AND start_time < :until AND completed = 1 "
+        "GROUP BY bucket)";
+
+    QSqlQuery query(m_db);
+    query.prepare(queryStr);
+    query.bindValue(":from", from.toString(Qt::ISODate));
+    query.bindValue(":until", to.addDays(1).toString(Qt::ISODate)); // ISO timestamps sort as text
+
+    if (!query.exec() || !query.next())
+    {
+        emit databaseError("Failed to get activity maximum: " + query.lastError().text());
+        return 0;
+    }
+
+    return query.value(0).toInt();
+}
+
 QList<QPair<QDate, int>> DatabaseManager::getDailyPomodoroStats(const QDate& from, const QDate& to)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::getDailyPomodoroStats");
+
     QList<QPair<QDate, int>> results;
 
     if (!m_initialized)
@@ -221,6 +584,8 @@ QList<QPair<QDate, int>> DatabaseManager::getDailyPomodoroStats(const QDate& fro
 
 bool DatabaseManager::clearOldData(const QDate& olderThan)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::clearOldData");
+
     if (!m_initialized)
     {
         emit databaseError("Database not initialized");
@@ -250,12 +615,24 @@ bool DatabaseManager::clearOldData(const QDate& olderThan)
         return false;
     }
 
+    // Delete timer events before local midnight of the cutoff day, matching the sessions
+    query.prepare("DELETE FROM session_events WHERE time_ms < :cutoff_ms");
+    query.bindValue(":cutoff_ms", QDateTime(olderThan, QTime(0, 0)).toMSecsSinceEpoch());
+    if (!query.exec())
+    {
+        m_db.rollback();
+        emit databaseError("Failed to clear old session events: " + query.lastError().text());
+        return false;
+    }
+
     m_db.commit();
     return true;
 }
 
 bool DatabaseManager::exportData(const QString& filePath)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::exportData");
+
     if (!m_initialized)
     {
         emit databaseError("Database not initialized");
@@ -274,6 +651,8 @@ bool DatabaseManager::exportData(const QString& filePath)
 
 bool DatabaseManager::importData(const QString& filePath)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::importData");
+
     if (!QFile::exists(filePath))
     {
         emit databaseError("Import file does not exist");
@@ -330,7 +709,10 @@ bool DatabaseManager::createTables()
         "id INTEGER PRIMARY KEY AUTOINCREMENT, "
         "start_time DATETIME NOT NULL, "
         "duration_seconds INTEGER NOT NULL, "
-        "completed BOOLEAN NOT NULL DEFAULT 0)"))
+        "completed BOOLEAN NOT NULL DEFAULT 0, "
+        "paused_seconds INTEGER NOT NULL DEFAULT 0, "
+        "interruptions INTEGER NOT NULL DEFAULT 0, "
+        "timeline BLOB)"))
     {
         m_db.rollback();
         return false;
@@ -341,7 +723,16 @@ bool DatabaseManager::createTables()
         "id INTEGER PRIMARY KEY AUTOINCREMENT, "
         "start_time DATETIME NOT NULL, "
         "duration_seconds INTEGER NOT NULL, "
-        "is_long_break BOOLEAN NOT NULL DEFAULT 0)"))
+        "is_long_break BOOLEAN NOT NULL DEFAULT 0, "
+        "paused_seconds INTEGER NOT NULL DEFAULT 0, "
+        "interruptions INTEGER NOT NULL DEFAULT 0, "
+        "timeline BLOB)"))
+    {
+        m_db.rollback();
+        return false;
+    }
+
+    if (!createEventTable())
     {
         m_db.rollback();
         return false;
@@ -361,7 +752,7 @@ bool DatabaseManager::createTables()
     }
 
     // Set initial schema version
-    if (!setSchemaVersion(1))
+    if (!setSchemaVersion(kSchemaVersion))
     {
         m_db.rollback();
         return false;
@@ -371,18 +762,63 @@ bool DatabaseManager::createTables()
     return true;
 }
 
+bool DatabaseManager::createEventTable()
+{
+    // Compact typed events; time_ms is milliseconds since the epoch
+    if (!executeSqlQuery("CREATE TABLE IF NOT EXISTS session_events ("
+        "id INTEGER PRIMARY KEY AUTOINCREMENT, "
+        "time_ms INTEGER NOT NULL, "
+        "type INTEGER NOT NULL, "
+        "mode INTEGER NOT NULL)"))
+    {
+        return false;
+    }
+
+    return executeSqlQuery("CREATE INDEX IF NOT EXISTS idx_session_events_time ON session_events(time_ms)");
+}
+
 bool DatabaseManager::upgradeSchema(int fromVersion, int toVersion)
 {
-    // This method will be used for future schema upgrades
-    // For now, we just return true since we don't need to upgrade anything yet
-    Q_UNUSED(fromVersion);
+    m_db.transaction();
+
+    if (fromVersion < 2)
+    {
+        // Existing rows keep their durations; they predate pause accounting
+        if (!executeSqlQuery("ALTER TABLE pomodoro_sessions ADD COLUMN paused_seconds INTEGER NOT NULL DEFAULT 0") ||
+            !executeSqlQuery("ALTER TABLE pomodoro_sessions ADD COLUMN interruptions INTEGER NOT NULL DEFAULT 0") ||
+            !executeSqlQuery("ALTER TABLE break_sessions ADD COLUMN paused_seconds INTEGER NOT NULL DEFAULT 0") ||
+            !executeSqlQuery("ALTER TABLE break_sessions ADD COLUMN interruptions INTEGER NOT NULL DEFAULT 0") ||
+            !createEventTable())
+        {
+            m_db.rollback();
+            return false;
+        }
+    }
 
-    setSchemaVersion(toVersion);
+    if (fromVersion < 3)
+    {
+        if (!executeSqlQuery("ALTER TABLE pomodoro_sessions ADD COLUMN timeline BLOB") ||
+            !executeSqlQuery("ALTER TABLE break_sessions ADD COLUMN timeline BLOB"))
+        {
+            m_db.rollback();
+            return false;
+        }
+    }
+
+    if (!setSchemaVersion(toVersion))
+    {
+        m_db.rollback();
+        return false;
+    }
+
+    m_db.commit();
     return true;
 }
 
 int DatabaseManager::getCurrentSchemaVersion()
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::getCurrentSchemaVersion");
+
     QSqlQuery query(m_db);
     query.prepare("SELECT version FROM schema_version ORDER BY version DESC LIMIT 1");
 
@@ -397,6 +833,8 @@ int DatabaseManager::getCurrentSchemaVersion()
 
 bool DatabaseManager::setSchemaVersion(int version)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::setSchemaVersion");
+
     QSqlQuery query(m_db);
     query.prepare("INSERT INTO schema_version (version) VALUES (:version)");
     query.bindValue(":version", version);
@@ -412,6 +850,11 @@ bool DatabaseManager::setSchemaVersion(int version)
 
 QString DatabaseManager::getDatabasePath() const
 {
+    if (!m_databasePath.isEmpty())
+    {
+        return m_databasePath;
+    }
+
     QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     QDir dir(dataPath);
 
@@ -425,6 +868,8 @@ QString DatabaseManager::getDatabasePath() const
 
 bool DatabaseManager::executeSqlQuery(const QString& queryStr, const QMap<QString, QVariant>& bindValues)
 {
+    ZP_TRACE_SCOPE("db", "DatabaseManager::executeSqlQuery");
+
     QSqlQuery query(m_db);
     query.prepare(queryStr);
 
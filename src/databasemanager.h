@@ -10,8 +10,56 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDateTime>
+#include <QVector>
 #include <QDebug>
 
+#include "clock.h"
+#include "sessionevent.h"
+
+// One recorded work session with its encoded SessionTimeline
+struct SessionTimelineRecord
+{
+    QDateTime startTime;
+    int durationSeconds = 0;
+    int pausedSeconds = 0;
+    int interruptions = 0;
+    bool completed = false;
+    QByteArray timeline;
+};
+
+// A session that has just been committed, so views can fold it into what
+// they already show instead of querying again
+struct RecordedSession
+{
+    enum class Kind
+    {
+        Work,
+        ShortBreak,
+        LongBreak
+    };
+
+    Kind kind = Kind::Work;
+    SessionTimelineRecord record; // Breaks always count as completed
+};
+Q_DECLARE_METATYPE(RecordedSession) // Crosses from the engine thread to the views
+
+// Bucket sizes for aggregated activity; weeks start on Monday
+enum class ActivityGranularity
+{
+    Day,
+    Week,
+    Month
+};
+
+// Work-session totals for one day, week or month
+struct ActivityBucket
+{
+    QDate start; // First day of the bucket
+    int pomodoros = 0; // Completed work sessions
+    int minutes = 0; // All work time, completed or not
+    int seconds = 0; // The same, exact
+};
+
 class DatabaseManager : public QObject
 {
     Q_OBJECT
@@ -21,43 +69,75 @@ public:
     ~DatabaseManager() override;
 
     // Database initialization
+    void setDatabasePath(const QString& path); // Call before initialize(); empty = default location
+    void setConnectionName(const QString& name); // One connection per thread; empty = default connection
+    void setReadOnly(bool readOnly); // Never create or upgrade; for reading other users' databases
+    QString getDatabasePath() const;
     bool initialize();
     bool isInitialized() const;
 
-    // Pomodoro session tracking
-    bool recordPomodoroSession(const QDateTime& startTime, int durationSeconds, bool completed);
-    bool recordBreakSession(const QDateTime& startTime, int durationSeconds, bool isLongBreak);
+    // Group many writes into one transaction (used by simulated runs)
+    bool beginBatch(); // False if a batch is already open
+    bool commitBatch(); // Rolls the batch back on failure
+
+    // Pomodoro session tracking; durations are active time, paused time is stored separately
+    bool recordPomodoroSession(const QDateTime& startTime, int durationSeconds, bool completed,
+                               int pausedSeconds = 0, int interruptions = 0,
+                               const QByteArray& timeline = QByteArray());
+    bool recordBreakSession(const QDateTime& startTime, int durationSeconds, bool isLongBreak,
+                            int pausedSeconds = 0, int interruptions = 0,
+                            const QByteArray& timeline = QByteArray());
+
+    // Append-only session event log
+    bool appendSessionEvents(const QVector<SessionEvent>& events);
+    // Logged events in [fromMs, toMs), oldest first; fold them with SessionTally::replay()
+    QVector<SessionEvent> getSessionEvents(qint64 fromMs, qint64 toMs);
 
     // Statistics retrieval
-    int getTotalCompletedPomodoros(const QDate& date = QDate::currentDate());
-    int getTotalWorkMinutes(const QDate& date = QDate::currentDate());
-    double getAverageSessionLength(const QDate& from = QDate::currentDate().addDays(-30),
-                                 const QDate& to = QDate::currentDate());
+    int getTotalCompletedPomodoros(const QDate& date = Clock::instance()->currentDate());
+    int getTotalWorkMinutes(const QDate& date = Clock::instance()->currentDate());
+    double getAverageSessionLength(const QDate& from = Clock::instance()->currentDate().addDays(-30),
+                                 const QDate& to = Clock::instance()->currentDate());
+
+    // Work sessions with their interruption timelines, oldest first
+    QList<SessionTimelineRecord> getSessionTimelines(const QDate& from, const QDate& to);
+
+    // Aggregated activity in one query; buckets without sessions are omitted
+    QList<ActivityBucket> getActivityBuckets(const QDate& from, const QDate& to, ActivityGranularity granularity);
+    int getMaxActivityBucket(const QDate& from, const QDate& to, ActivityGranularity granularity);
 
     // Time tracking
-    QList<QPair<QDate, int>> getDailyPomodoroStats(const QDate& from = QDate::currentDate().addDays(-7),
-                                                 const QDate& to = QDate::currentDate());
+    QList<QPair<QDate, int>> getDailyPomodoroStats(const QDate& from = Clock::instance()->currentDate().addDays(-7),
+                                                 const QDate& to = Clock::instance()->currentDate());
 
     // Database maintenance
-    bool clearOldData(const QDate& olderThan = QDate::currentDate().addMonths(-3));
+    bool clearOldData(const QDate& olderThan = Clock::instance()->currentDate().addMonths(-3));
     bool exportData(const QString& filePath);
     bool importData(const QString& filePath);
 
 signals:
     void databaseError(const QString& errorMessage);
+    void sessionRecorded(const RecordedSession& session); // After commit; batched sessions on commitBatch()
 
 private:
     QSqlDatabase m_db;
     bool m_initialized;
+    QString m_databasePath;
+    QString m_connectionName;
+    bool m_readOnly;
+    bool m_inBatch;
+    QVector<RecordedSession> m_pendingSessions; // Recorded in the open batch
+
+    void notifyRecorded(const RecordedSession& session);
 
     // Database setup methods
     bool createTables();
+    bool createEventTable();
     bool upgradeSchema(int fromVersion, int toVersion);
     int getCurrentSchemaVersion();
     bool setSchemaVersion(int version);
 
     // Helper methods
-    QString getDatabasePath() const;
     bool executeSqlQuery(const QString& queryStr, const QMap<QString, QVariant>& bindValues = QMap<QString, QVariant>());
 };
 
@@ -0,0 +1,70 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "lttb.h"
+
+#include <cmath>
+
+QVector<QPointF> Lttb::downsample(const QVector<QPointF>& points, int threshold)
+{
+    const int count = points.size();
+    if (threshold >= count || threshold < 3)
+    {
+        return points;
+    }
+
+    QVector<QPointF> sampled;
+    sampled.reserve(threshold);
+    sampled.append(points.first());
+
+    // The first and last points are fixed; the rest split into threshold - 2 buckets
+    const double bucketSize = double(count - 2) / (threshold - 2);
+    int previous = 0;
+
+    for (int bucket = 0; bucket < threshold - 2; bucket++)
+    {
+        // Average of the next bucket (just the last point for the final one)
+        int nextStart = int(std::floor((bucket + 1) * bucketSize)) + 1;
+        int nextEnd = qMin(int(std::floor((bucket + 2) * bucketSize)) + 1, count);
+        if (bucket == threshold - 3 || nextStart >= count - 1)
+        {
+            nextStart = count - 1;
+            nextEnd = count;
+        }
+
+        double avgX = 0.0;
+        double avgY = 0.0;
+        for (int i = nextStart; i < nextEnd; i++)
+        {
+            avgX += points[i].x();
+            avgY += points[i].y();
+        }
+        avgX /= nextEnd - nextStart;
+        avgY /= nextEnd - nextStart;
+
+        // Point of this bucket with the largest triangle (area doubled; only the order matters)
+        int start = int(std::floor(bucket * bucketSize)) + 1;
+        int end = bucket == threshold - 3 ? count - 1 : int(std::floor((bucket + 1) * bucketSize)) + 1;
+        const QPointF& a = points[previous];
+
+        double maxArea = -1.0;
+        int picked = start;
+        for (int i = start; i < end; i++)
+        {
+            double area = std::abs((a.x() - avgX) * (points[i].y() - a.y())
+                                   - (a.x() - points[i].x()) * (avgY - a.y()));
+            if (area > maxArea)
+            {
+                maxArea = area;
+                picked = i;
+            }
+        }
+
+        sampled.append(points[picked]);
+        previous = picked;
+    }
+
+    sampled.append(points.last());
+    return sampled;
+}
@@ -0,0 +1,22 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_LTTB_H
+#define ZIGA_POMODORO_LTTB_H
+
+#include <QVector>
+#include <QPointF>
+
+// Largest-Triangle-Three-Buckets downsampling of a line series. Keeps the
+// first and last points and, from each of the buckets in between, the point
+// forming the largest triangle with the previous pick and the next bucket's
+// average, so peaks and dips survive. Points must be sorted by x.
+class Lttb
+{
+public:
+    // At most threshold points; the input unchanged when it is already small enough
+    static QVector<QPointF> downsample(const QVector<QPointF>& points, int threshold);
+};
+
+#endif // ZIGA_POMODORO_LTTB_H
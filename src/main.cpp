@@ -5,6 +5,9 @@
 #include "timerwindow.h"
 #include "settings.h"
 #include "databasemanager.h" // Add include for DatabaseManager
+#include "sessioncontroller.h"
+#include "paintprofiler.h"
+#include "trace.h"
 #include <QApplication>
 #include <QDir>
 
@@ -34,11 +37,42 @@ int main(int argc, char* argv[])
         qWarning() << "Failed to initialize database, continuing without persistence";
     }
 
+    // The controller owns the one timer engine; every window shares it
+    SessionController sessionController(appSettings);
+    sessionController.setDatabaseManager(dbManager);
+
+    // Resume where the previous run left off, before any window is shown
+    sessionController.restoreSession();
+
     // Initialize and display the timer window, passing the settings object
-    TimerWindow timerWindow(appSettings);
+    TimerWindow timerWindow(appSettings, &sessionController);
     timerWindow.setDatabaseManager(dbManager); // Add this method to TimerWindow
+
+    // Paint instrumentation is opt-in: --paint-stats
+    if (QApplication::arguments().contains("--paint-stats"))
+    {
+        timerWindow.setPaintProfiler(new PaintProfiler(&app));
+    }
     timerWindow.show();
 
+#ifdef ZIGA_POMODORO_TRACE
+    // Trace events are recorded all along; --trace-file <path> writes the
+    // ring buffer as Chrome trace JSON on exit
+    const QStringList arguments = QApplication::arguments();
+    int traceIndex = arguments.indexOf("--trace-file");
+    if (traceIndex > 0 && traceIndex + 1 < arguments.size())
+    {
+        QString tracePath = arguments.at(traceIndex + 1);
+        QObject::connect(&app, &QApplication::aboutToQuit, [tracePath]()
+        {
+            if (!Trace::exportJson(tracePath))
+            {
+                qWarning() << "Failed to write trace to" << tracePath;
+            }
+        });
+    }
+#endif
+
     // Make sure resources outlive the application
     QObject::connect(&app, &QApplication::aboutToQuit, [appSettings, dbManager]()
     {
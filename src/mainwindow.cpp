@@ -16,17 +16,22 @@
 #include <QVBoxLayout>    // For QVBoxLayout
 #include <QGroupBox>     // For QGroupBox
 #include <QColorDialog>  // For QColorDialog
+#include <QLineEdit>     // For QLineEdit
+#include <QHeaderView>   // For QHeaderView
+#include "sessiontimeline.h"
 
 
 // In mainwindow.cpp
-MainWindow::MainWindow(Settings* settings, QWidget* parent)
+MainWindow::MainWindow(Settings* settings, SessionController* controller, QWidget* parent)
     : QMainWindow(parent)
-      , m_timer(new Timer(this))
+      , m_controller(controller)
       , m_settings(settings) // Use the passed settings object
-#ifdef HAVE_QT_MULTIMEDIA
-      , m_mediaPlayer(new QMediaPlayer(this))
-#endif
+      , m_dbManager(nullptr)
       , m_totalTime(0)
+      , m_rangePomodoros(0)
+      , m_rangeMinutes(0)
+      , m_completedSeconds(0)
+      , m_rangeSessions(0)
 {
     setupUi();
     setupTrayIcon();
@@ -35,17 +40,9 @@ MainWindow::MainWindow(Settings* settings, QWidget* parent)
     // Apply settings
     applySettings();
 
-
-    handlePomodorosCompletedChanged(m_timer->getTotalCompletedPomodoros());
-
     // Set window title
     setWindowTitle("Ziga-Pomodoro");
     setWindowIcon(QIcon(":/icons/tomato.png"));
-
-#ifdef HAVE_QT_MULTIMEDIA
-
-    m_mediaPlayer->setVolume(100);
-#endif
 }
 
 MainWindow::~MainWindow() = default;
@@ -114,6 +111,11 @@ void MainWindow::setupUi()
     // Add summary layout to main layout
     m_mainLayout->addLayout(summaryLayout);
 
+    // Rolling metrics under the totals
+    m_analyticsLabel = new QLabel(m_centralWidget);
+    m_analyticsLabel->setAlignment(Qt::AlignCenter);
+    m_mainLayout->addWidget(m_analyticsLabel);
+
     // Create date range selection
     QHBoxLayout* dateRangeLayout = new QHBoxLayout();
 
@@ -130,24 +132,21 @@ void MainWindow::setupUi()
     QLabel* fromLabel = new QLabel("From:", m_centralWidget);
     m_fromDateEdit = new QDateEdit(m_centralWidget);
     m_fromDateEdit->setCalendarPopup(true);
-    m_fromDateEdit->setDate(QDate::currentDate().addDays(-7));
+    m_fromDateEdit->setDate(Clock::instance()->currentDate().addDays(-7));
     m_fromDateEdit->setEnabled(false); // Initially disabled
 
     QLabel* toLabel = new QLabel("To:", m_centralWidget);
     m_toDateEdit = new QDateEdit(m_centralWidget);
     m_toDateEdit->setCalendarPopup(true);
-    m_toDateEdit->setDate(QDate::currentDate());
+    m_toDateEdit->setDate(Clock::instance()->currentDate());
     m_toDateEdit->setEnabled(false); // Initially disabled
 
-    m_refreshButton = new QPushButton("Refresh", m_centralWidget);
-
     dateRangeLayout->addWidget(viewLabel);
     dateRangeLayout->addWidget(m_timeRangeCombo);
     dateRangeLayout->addWidget(fromLabel);
     dateRangeLayout->addWidget(m_fromDateEdit);
     dateRangeLayout->addWidget(toLabel);
     dateRangeLayout->addWidget(m_toDateEdit);
-    dateRangeLayout->addWidget(m_refreshButton);
     dateRangeLayout->addStretch();
 
     m_mainLayout->addLayout(dateRangeLayout);
@@ -156,6 +155,37 @@ void MainWindow::setupUi()
     m_activityMap = new PomodoroActivityMap(m_centralWidget);
     m_mainLayout->addWidget(m_activityMap);
 
+    // Create trend chart
+    QHBoxLayout* trendLayout = new QHBoxLayout();
+    QLabel* trendLabel = new QLabel("Trend:", m_centralWidget);
+    m_trendMetricCombo = new QComboBox(m_centralWidget);
+    m_trendMetricCombo->addItem("Pomodoros");
+    m_trendMetricCombo->addItem("Minutes");
+    m_trendLevelCombo = new QComboBox(m_centralWidget);
+    m_trendLevelCombo->addItem("Daily");
+    m_trendLevelCombo->addItem("Weekly");
+
+    trendLayout->addWidget(trendLabel);
+    trendLayout->addWidget(m_trendMetricCombo);
+    trendLayout->addWidget(m_trendLevelCombo);
+    trendLayout->addStretch();
+    m_mainLayout->addLayout(trendLayout);
+
+    m_trendChart = new TrendChart(m_centralWidget);
+    m_mainLayout->addWidget(m_trendChart);
+
+    // Create per-session interruption view
+    m_interruptionSummaryLabel = new QLabel(m_centralWidget);
+    m_mainLayout->addWidget(m_interruptionSummaryLabel);
+
+    m_sessionTable = new QTableWidget(0, 6, m_centralWidget);
+    m_sessionTable->setHorizontalHeaderLabels({"Start", "Focus", "Paused", "Pauses", "Longest Stretch", "Focus Stretches"});
+    m_sessionTable->horizontalHeader()->setStretchLastSection(true);
+    m_sessionTable->verticalHeader()->setVisible(false);
+    m_sessionTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_sessionTable->setSelectionMode(QAbstractItemView::NoSelection);
+    m_mainLayout->addWidget(m_sessionTable);
+
     // Add spacer to push content to the top
     m_mainLayout->addStretch();
 
@@ -182,8 +212,8 @@ void MainWindow::setupUi()
     setWindowIcon(QIcon(":/icons/tomato.png"));
 
     // Initialize date range
-    m_fromDate = QDate::currentDate().addDays(-7);
-    m_toDate = QDate::currentDate();
+    m_fromDate = Clock::instance()->currentDate().addDays(-7);
+    m_toDate = Clock::instance()->currentDate();
 }
 
 void MainWindow::setupTrayIcon()
@@ -216,9 +246,6 @@ void MainWindow::setupTrayIcon()
 // In mainwindow.cpp - setupConnections()
 void MainWindow::setupConnections()
 {
-    // Connect timer signals (for statistics only)
-    connect(m_timer, &Timer::pomodorosCompletedChanged, this, &MainWindow::handlePomodorosCompletedChanged);
-
     // Connect settings button
     connect(m_settingsButton, &QPushButton::clicked, this, &MainWindow::onSettingsButtonClicked);
 
@@ -231,16 +258,64 @@ void MainWindow::setupConnections()
             this, &MainWindow::onTimeRangeChanged);
     connect(m_fromDateEdit, &QDateEdit::dateChanged, this, &MainWindow::onCustomDateRangeChanged);
     connect(m_toDateEdit, &QDateEdit::dateChanged, this, &MainWindow::onCustomDateRangeChanged);
-    connect(m_refreshButton, &QPushButton::clicked, this, &MainWindow::onRefreshStats);
+    connect(m_trendMetricCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onTrendOptionsChanged);
+    connect(m_trendLevelCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &MainWindow::onTrendOptionsChanged);
 
     connect(m_quitAction, &QAction::triggered, qApp, &QApplication::quit);
+
+    // Sessions are recorded on the engine's own connection; the controller forwards them
+    connect(m_controller, &SessionController::sessionRecorded, this, &MainWindow::onSessionRecorded);
+    connect(m_controller, &SessionController::sessionRecorded, m_activityMap, &PomodoroActivityMap::onSessionRecorded);
+    connect(m_controller, &SessionController::sessionRecorded, m_trendChart, &TrendChart::onSessionRecorded);
 }
 
 
-void MainWindow::handlePomodorosCompletedChanged(int count)
+void MainWindow::onTrendOptionsChanged()
+{
+    m_trendChart->setMetric(m_trendMetricCombo->currentIndex() == 1
+                                ? TrendChart::Metric::Minutes
+                                : TrendChart::Metric::Pomodoros);
+    m_trendChart->setGranularity(m_trendLevelCombo->currentIndex() == 1
+                                     ? ActivityGranularity::Week
+                                     : ActivityGranularity::Day);
+}
+
+void MainWindow::onSessionRecorded(const RecordedSession& session)
 {
-    // m_pomodorosCompletedLabel->setText(QString("Pomodoros completed: %1").arg(count));
-    m_pomodorosCompletedLabel->setText(QString::number(count));
+    const SessionTimelineRecord& record = session.record;
+    QDate date = record.startTime.date();
+    if (session.kind != RecordedSession::Kind::Work)
+    {
+        return;
+    }
+
+    // Preset ranges end today, so after midnight they move on to the new day
+    if (date > m_toDate && m_timeRangeCombo->currentIndex() != 5)
+    {
+        onTimeRangeChanged(m_timeRangeCombo->currentIndex()); // Reads the committed session too
+        return;
+    }
+
+    if (date < m_fromDate || date > m_toDate)
+    {
+        return;
+    }
+
+    // Newest session goes on top; the labels follow from the totals
+    SessionTimeline::Summary summary = addToTotals(record);
+    m_sessionTable->insertRow(0);
+    setSessionRow(0, record, summary);
+    updateSummaryLabels();
+
+    if (record.completed)
+    {
+        // Outside the loaded series the day would be misplaced, so load it again
+        updateAnalyticsLabel(m_analytics.addCompleted(date)
+                                 ? m_analytics.report()
+                                 : m_analytics.analyze(m_dbManager, m_fromDate, m_toDate));
+    }
 }
 
 void MainWindow::onSettingsButtonClicked()
@@ -273,30 +348,10 @@ void MainWindow::closeEvent(QCloseEvent* event)
     event->ignore();
 }
 
-// Not as important
-void MainWindow::playNotificationSound()
-{
-#ifdef HAVE_QT_MULTIMEDIA
-    if (m_settings->getSoundEnabled())
-    {
-        m_mediaPlayer->setMedia(QUrl::fromLocalFile(m_settings->getSoundFile()));
-        m_mediaPlayer->play();
-    }
-#endif
-}
-
-void MainWindow::showDesktopNotification(const QString& title, const QString& message)
-{
-    if (m_settings->getDesktopNotificationsEnabled())
-    {
-        m_trayIcon->showMessage(title, message, QSystemTrayIcon::Information, 3000);
-    }
-}
-
 void MainWindow::updateWindowTitle()
 {
     QString stateStr;
-    switch (m_timer->getState())
+    switch (m_controller->getTimer()->getState())
     {
     case Timer::TimerState::Running:
         stateStr = "Running";
@@ -310,7 +365,7 @@ void MainWindow::updateWindowTitle()
     }
 
     QString modeStr;
-    switch (m_timer->getMode())
+    switch (m_controller->getTimer()->getMode())
     {
     case Timer::TimerMode::Work:
         modeStr = "Work";
@@ -333,12 +388,7 @@ void MainWindow::updateWindowTitle()
 
 void MainWindow::applySettings()
 {
-    // Apply timer settings
-    m_timer->setWorkDuration(m_settings->getWorkDuration());
-    m_timer->setShortBreakDuration(m_settings->getShortBreakDuration());
-    m_timer->setLongBreakDuration(m_settings->getLongBreakDuration());
-    m_timer->setLongBreakInterval(m_settings->getLongBreakInterval());
-
+    // Timer settings are applied by the session controller
     // Apply UI settings
     loadStyleSheet(m_settings->getTheme());
 }
@@ -388,7 +438,7 @@ void MainWindow::showSettingsDialog()
 
     QSpinBox* longBreakIntervalSpinBox = new QSpinBox(timerTab);
     longBreakIntervalSpinBox->setMinimum(1);
-    longBreakIntervalSpinBox->setMaximum(10);
+    longBreakIntervalSpinBox->setMaximum(10); // Classic plans hold up to SessionSchedule::MaxSteps / 2
     longBreakIntervalSpinBox->setValue(m_settings->getLongBreakInterval());
 
     timerLayout->addRow("Work duration (minutes):", workDurationSpinBox);
@@ -396,6 +446,53 @@ void MainWindow::showSettingsDialog()
     timerLayout->addRow("Long break duration (minutes):", longBreakDurationSpinBox);
     timerLayout->addRow("Long break interval (pomodoros):", longBreakIntervalSpinBox);
 
+    // Session plan
+    QComboBox* schedulePlanComboBox = new QComboBox(timerTab);
+    schedulePlanComboBox->addItem("Classic", "classic");
+    schedulePlanComboBox->addItem("52 / 17", "52-17");
+    schedulePlanComboBox->addItem("90 min ultradian", "ultradian");
+    schedulePlanComboBox->addItem("Warm-up + classic", "warmup");
+    schedulePlanComboBox->addItem("Custom", "custom");
+    schedulePlanComboBox->setCurrentIndex(qMax(0, schedulePlanComboBox->findData(m_settings->getSchedulePlan())));
+
+    QLineEdit* customScheduleEdit = new QLineEdit(m_settings->getCustomSchedule(), timerTab);
+    customScheduleEdit->setPlaceholderText("e.g. w10 s3 | w25 s5 w25 s5 w25 l15");
+    customScheduleEdit->setEnabled(schedulePlanComboBox->currentData().toString() == "custom");
+
+    // Why a custom plan would be rejected, shown as it is typed
+    QLabel* customScheduleError = new QLabel(timerTab);
+    customScheduleError->setStyleSheet("color: #c0392b;");
+    customScheduleError->setWordWrap(true);
+
+    auto customPlanError = [schedulePlanComboBox, customScheduleEdit]()
+    {
+        QString error;
+        if (schedulePlanComboBox->currentData().toString() == "custom")
+        {
+            SessionSchedule::parse(customScheduleEdit->text().trimmed(), nullptr, &error);
+        }
+        return error;
+    };
+    auto updateCustomPlanError = [customScheduleError, customPlanError]()
+    {
+        QString error = customPlanError();
+        customScheduleError->setText(error);
+        customScheduleError->setVisible(!error.isEmpty());
+    };
+
+    connect(schedulePlanComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            [schedulePlanComboBox, customScheduleEdit, updateCustomPlanError](int)
+            {
+                customScheduleEdit->setEnabled(schedulePlanComboBox->currentData().toString() == "custom");
+                updateCustomPlanError();
+            });
+    connect(customScheduleEdit, &QLineEdit::textChanged, updateCustomPlanError);
+    updateCustomPlanError();
+
+    timerLayout->addRow("Session plan:", schedulePlanComboBox);
+    timerLayout->addRow("Custom plan:", customScheduleEdit);
+    timerLayout->addRow("", customScheduleError);
+
     // Notifications tab
     QWidget* notificationsTab = new QWidget(tabWidget);
     QVBoxLayout* notificationsLayout = new QVBoxLayout(notificationsTab);
@@ -439,6 +536,12 @@ void MainWindow::showSettingsDialog()
     QString currentColor = m_settings->getFontColor();
     fontColorButton->setStyleSheet(QString("background-color: %1;").arg(currentColor));
 
+    QCheckBox* progressRingCheckBox = new QCheckBox("Show progress ring", uiTab);
+    progressRingCheckBox->setChecked(m_settings->getProgressRingEnabled());
+
+    QCheckBox* shapeMaskCheckBox = new QCheckBox("Opaque shape-masked timer window", uiTab);
+    shapeMaskCheckBox->setChecked(m_settings->getShapeMaskEnabled());
+
     // Text shadow checkbox
     QCheckBox* textShadowCheckBox = new QCheckBox("Enable text shadow", uiTab);
     textShadowCheckBox->setChecked(m_settings->getTextShadowEnabled());
@@ -511,6 +614,8 @@ void MainWindow::showSettingsDialog()
     uiLayout->addLayout(themeLayout);
     uiLayout->addWidget(minimizeToTrayCheckBox);
     uiLayout->addWidget(startMinimizedCheckBox);
+    uiLayout->addWidget(progressRingCheckBox);
+    uiLayout->addWidget(shapeMaskCheckBox);
     uiLayout->addWidget(textShadowCheckBox);
     uiLayout->addWidget(shadowGroupBox);
     uiLayout->addStretch();
@@ -530,15 +635,34 @@ void MainWindow::showSettingsDialog()
     mainLayout->addWidget(buttonBox);
 
     // Connect signals
-    connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::accepted, [&dialog, tabWidget, timerTab, customScheduleEdit, customPlanError]()
+    {
+        // Keep the dialog open on an invalid plan rather than quietly using the classic one
+        if (!customPlanError().isEmpty())
+        {
+            tabWidget->setCurrentWidget(timerTab);
+            customScheduleEdit->setFocus();
+            return;
+        }
+        dialog.accept();
+    });
     connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
     connect(buttonBox->button(QDialogButtonBox::Apply), &QPushButton::clicked, [=]()
     {
+        if (!customPlanError().isEmpty())
+        {
+            tabWidget->setCurrentWidget(timerTab);
+            customScheduleEdit->setFocus();
+            return;
+        }
+
         // Apply settings
         m_settings->setWorkDuration(workDurationSpinBox->value());
         m_settings->setShortBreakDuration(shortBreakDurationSpinBox->value());
         m_settings->setLongBreakDuration(longBreakDurationSpinBox->value());
         m_settings->setLongBreakInterval(longBreakIntervalSpinBox->value());
+        m_settings->setSchedulePlan(schedulePlanComboBox->currentData().toString());
+        m_settings->setCustomSchedule(customScheduleEdit->text().trimmed());
 
         m_settings->setSoundEnabled(soundEnabledCheckBox->isChecked());
         m_settings->setDesktopNotificationsEnabled(desktopNotificationsEnabledCheckBox->isChecked());
@@ -546,6 +670,8 @@ void MainWindow::showSettingsDialog()
         m_settings->setTheme(themeComboBox->currentData().toString());
         m_settings->setMinimizeToTray(minimizeToTrayCheckBox->isChecked());
         m_settings->setStartMinimized(startMinimizedCheckBox->isChecked());
+        m_settings->setShapeMaskEnabled(shapeMaskCheckBox->isChecked());
+        m_settings->setProgressRingEnabled(progressRingCheckBox->isChecked());
 
         // Apply new font settings
         m_settings->setFontSize(fontSizeSpinBox->value());
@@ -583,6 +709,8 @@ void MainWindow::showSettingsDialog()
         m_settings->setShortBreakDuration(shortBreakDurationSpinBox->value());
         m_settings->setLongBreakDuration(longBreakDurationSpinBox->value());
         m_settings->setLongBreakInterval(longBreakIntervalSpinBox->value());
+        m_settings->setSchedulePlan(schedulePlanComboBox->currentData().toString());
+        m_settings->setCustomSchedule(customScheduleEdit->text().trimmed());
 
         m_settings->setSoundEnabled(soundEnabledCheckBox->isChecked());
         m_settings->setDesktopNotificationsEnabled(desktopNotificationsEnabledCheckBox->isChecked());
@@ -590,6 +718,8 @@ void MainWindow::showSettingsDialog()
         m_settings->setTheme(themeComboBox->currentData().toString());
         m_settings->setMinimizeToTray(minimizeToTrayCheckBox->isChecked());
         m_settings->setStartMinimized(startMinimizedCheckBox->isChecked());
+        m_settings->setShapeMaskEnabled(shapeMaskCheckBox->isChecked());
+        m_settings->setProgressRingEnabled(progressRingCheckBox->isChecked());
 
         // Apply new font settings
         m_settings->setFontSize(fontSizeSpinBox->value());
@@ -627,13 +757,20 @@ void MainWindow::setDatabaseManager(DatabaseManager* dbManager)
     if (m_dbManager && m_activityMap)
     {
         m_activityMap->setDatabaseManager(m_dbManager);
+        m_trendChart->setDatabaseManager(m_dbManager);
         updateStatistics();
     }
 }
 
+void MainWindow::setPaintProfiler(PaintProfiler* profiler)
+{
+    m_activityMap->setPaintStats(profiler ? profiler->statsFor("PomodoroActivityMap") : nullptr);
+    m_trendChart->setPaintStats(profiler ? profiler->statsFor("TrendChart") : nullptr);
+}
+
 void MainWindow::onTimeRangeChanged(int index)
 {
-    QDate currentDate = QDate::currentDate();
+    QDate currentDate = Clock::instance()->currentDate();
 
     // Disable date edits by default
     m_fromDateEdit->setEnabled(false);
@@ -701,9 +838,12 @@ void MainWindow::onCustomDateRangeChanged()
     }
 }
 
-void MainWindow::onRefreshStats()
+namespace
 {
-    updateStatistics();
+QString formatDuration(qint64 seconds)
+{
+    return QString("%1:%2").arg(seconds / 60).arg(seconds % 60, 2, 10, QChar('0'));
+}
 }
 
 void MainWindow::updateStatistics()
@@ -716,29 +856,123 @@ void MainWindow::updateStatistics()
     // Update activity map with the selected date range
     if (m_activityMap)
     {
-        m_activityMap->setDateRange(m_fromDate, m_toDate);
-        m_activityMap->refreshData();
+        m_activityMap->setDateRange(m_fromDate, m_toDate); // Reloads what is in view
     }
+    m_trendChart->setDateRange(m_fromDate, m_toDate); // Queries only on its next uncached paint
 
-    // Update summary statistics labels
-    int totalPomodoros = 0;
-    int totalMinutes = 0;
+    // Moving averages, week over week and weekdays in one query and one pass
+    updateAnalyticsLabel(m_analytics.analyze(m_dbManager, m_fromDate, m_toDate));
 
-    // Calculate statistics for each day in the range
-    QDate date = m_fromDate;
-    while (date <= m_toDate)
+    // One query for the range; sessions recorded later are added as they arrive
+    QList<SessionTimelineRecord> records = m_dbManager->getSessionTimelines(m_fromDate, m_toDate);
+
+    m_rangePomodoros = 0;
+    m_rangeMinutes = 0;
+    m_rangeDaySeconds.clear();
+    m_completedSeconds = 0;
+    m_rangeSessions = 0;
+    m_timelineTotal = SessionTimeline::Summary();
+
+    // Newest session first
+    m_sessionTable->setUpdatesEnabled(false);
+    m_sessionTable->setRowCount(records.size());
+    for (int i = 0; i < records.size(); i++)
     {
-        totalPomodoros += m_dbManager->getTotalCompletedPomodoros(date);
-        totalMinutes += m_dbManager->getTotalWorkMinutes(date);
-        date = date.addDays(1);
+        const SessionTimelineRecord& record = records.at(i);
+        setSessionRow(records.size() - 1 - i, record, addToTotals(record));
     }
+    m_sessionTable->setUpdatesEnabled(true);
+
+    updateSummaryLabels();
+}
 
-    // Update the labels
-    m_pomodorosCompletedLabel->setText(QString::number(totalPomodoros));
-    m_totalTimeLabel->setText(QString("%1 min").arg(totalMinutes));
+SessionTimeline::Summary MainWindow::addToTotals(const SessionTimelineRecord& record)
+{
+    // Minutes are whole minutes per day, as the daily totals have always been shown
+    int& daySeconds = m_rangeDaySeconds[record.startTime.date()];
+    m_rangeMinutes -= daySeconds / 60;
+    daySeconds += record.durationSeconds;
+    m_rangeMinutes += daySeconds / 60;
 
-    // Calculate average session length
-    double avgSession = m_dbManager->getAverageSessionLength(m_fromDate, m_toDate);
+    if (record.completed)
+    {
+        m_rangePomodoros++;
+        m_completedSeconds += record.durationSeconds;
+    }
+
+    SessionTimeline::Summary summary = SessionTimeline::summarize(record.timeline);
+    m_timelineTotal.add(summary);
+    m_rangeSessions++;
+    return summary;
+}
+
+void MainWindow::setSessionRow(int row, const SessionTimelineRecord& record, const SessionTimeline::Summary& summary)
+{
+    // Lengths of the active stretches between pauses
+    QStringList stretches;
+    qint32 segmentStart = 0;
+    bool running = true;
+    SessionTimeline::forEachMark(record.timeline, [&](const SessionTimeline::Mark& mark)
+    {
+        if (running)
+        {
+            stretches.append(formatDuration(mark.offsetSeconds - segmentStart));
+        }
+        running = mark.type == SessionEvent::Type::Resume;
+        segmentStart = mark.offsetSeconds;
+    });
+
+    QString start = record.startTime.toString("yyyy-MM-dd hh:mm");
+    if (!record.completed)
+    {
+        start += " (stopped)";
+    }
+
+    m_sessionTable->setItem(row, 0, new QTableWidgetItem(start));
+    m_sessionTable->setItem(row, 1, new QTableWidgetItem(formatDuration(record.durationSeconds)));
+    m_sessionTable->setItem(row, 2, new QTableWidgetItem(formatDuration(record.pausedSeconds)));
+    m_sessionTable->setItem(row, 3, new QTableWidgetItem(QString::number(record.interruptions)));
+    m_sessionTable->setItem(row, 4, new QTableWidgetItem(
+                                record.timeline.isEmpty() ? QString("-") : formatDuration(summary.longestFocusSeconds)));
+    m_sessionTable->setItem(row, 5, new QTableWidgetItem(
+                                record.timeline.isEmpty() ? QString("-") : stretches.join(" | ")));
+}
+
+void MainWindow::updateSummaryLabels()
+{
+    m_pomodorosCompletedLabel->setText(QString::number(m_rangePomodoros));
+    m_totalTimeLabel->setText(QString("%1 min").arg(m_rangeMinutes));
+
+    // Average length of completed sessions
+    double avgSession = m_rangePomodoros > 0 ? m_completedSeconds / 60.0 / m_rangePomodoros : 0.0;
     m_avgSessionLabel->setText(QString("%1 min").arg(avgSession, 0, 'f', 1));
+
+    m_interruptionSummaryLabel->setText(QString("Sessions: %1   Pauses: %2   Time paused: %3   Longest stretch: %4")
+                                        .arg(m_rangeSessions)
+                                        .arg(m_timelineTotal.pauses)
+                                        .arg(formatDuration(m_timelineTotal.pausedSeconds))
+                                        .arg(formatDuration(m_timelineTotal.longestFocusSeconds)));
 }
 
+void MainWindow::updateAnalyticsLabel(const AnalyticsReport& report)
+{
+    QStringList parts;
+    for (const RollingAverage& average : report.averages)
+    {
+        parts.append(QString("%1-day avg: %2/day").arg(average.days).arg(average.latest, 0, 'f', 1));
+    }
+
+    QString change = report.lastWeek > 0
+                         ? QString("%1%2%").arg(report.weekOverWeek >= 0 ? "+" : "")
+                                           .arg(report.weekOverWeek * 100, 0, 'f', 0)
+                         : QString("n/a");
+    parts.append(QString("This week: %1 (%2 vs last week)").arg(report.thisWeek).arg(change));
+
+    if (report.bestWeekday != 0)
+    {
+        parts.append(QString("Best day: %1").arg(QLocale().dayName(report.bestWeekday)));
+        parts.append(QString("Worst day: %1").arg(QLocale().dayName(report.worstWeekday)));
+    }
+
+    m_analyticsLabel->setText(parts.join("   "));
+}
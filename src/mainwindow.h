@@ -13,16 +13,18 @@
 #include <QHBoxLayout>         // Horizontal layout manager
 #include <QComboBox>           // Dropdown selection widget
 #include <QDateEdit>           // Date selection widget
+#include <QTableWidget>        // Per-session interruption table
 
-// Conditional multimedia support
-#ifdef HAVE_QT_MULTIMEDIA
-#include <QMediaPlayer>        // Audio/video playback
-#endif
 // Application-specific headers
 #include "timer.h"             // Timer logic implementation
 #include "settings.h"          // User settings management
 #include "databasemanager.h"   // Database management
 #include "pomodoroactivitymap.h" // Pomodoro activity heatmap
+#include "trendchart.h"        // Daily/weekly trend lines
+#include "sessioncontroller.h" // Owner of the timer engine
+#include "paintprofiler.h"     // Opt-in paint statistics
+#include "sessiontimeline.h"   // Interruption summaries
+#include "analyticsengine.h"   // Rolling averages and weekday stats
 
 // Main application window class
 class MainWindow : public QMainWindow
@@ -30,22 +32,23 @@ class MainWindow : public QMainWindow
     Q_OBJECT // Required for Qt signals/slots and meta-object system
 
 public:
-    explicit MainWindow(Settings* settings, QWidget* parent = nullptr);
+    MainWindow(Settings* settings, SessionController* controller, QWidget* parent = nullptr);
     ~MainWindow() override; // Destructor with override specifier
     friend class TimerWindow;
 
     void setDatabaseManager(DatabaseManager* dbManager);
+    void setPaintProfiler(PaintProfiler* profiler);
 
 protected:
     // Window management
     void closeEvent(QCloseEvent* event) override; // Handle window closing
 
 private slots:
-    void handlePomodorosCompletedChanged(int count); // Update completed counter
+    void onSessionRecorded(const RecordedSession& session); // Fold a new session into the shown stats
     void onSettingsButtonClicked(); // Open settings
     void onTimeRangeChanged(int index); // Handle time range selection
     void onCustomDateRangeChanged(); // Handle custom date range
-    void onRefreshStats(); // Refresh statistics
+    void onTrendOptionsChanged(); // Metric or level of the trend chart
 
     // System tray interactions
     void onTrayIconActivated(QSystemTrayIcon::ActivationReason reason); // Tray icon clicks
@@ -59,11 +62,11 @@ private:
     void setupTrayIcon(); // Configure system tray integration
     void setupConnections(); // Connect signals to slots
     void setupStatisticsTab(); // Set up the statistics UI
-    void updateStatistics(); // Update statistics display
-
-    // Notification system
-    void playNotificationSound(); // Audio feedback
-    void showDesktopNotification(const QString& title, const QString& message); // OS notifications
+    void updateStatistics(); // Reload the selected range
+    SessionTimeline::Summary addToTotals(const SessionTimelineRecord& record); // Range aggregates
+    void setSessionRow(int row, const SessionTimelineRecord& record, const SessionTimeline::Summary& summary);
+    void updateSummaryLabels(); // From the range aggregates
+    void updateAnalyticsLabel(const AnalyticsReport& report); // Moving averages, week over week, weekdays
 
     // UI updates
     void updateWindowTitle(); // Update title bar text
@@ -77,16 +80,25 @@ private:
     QLabel* m_pomodorosCompletedLabel; // Completed sessions counter
     QLabel* m_totalTimeLabel; // Total work time
     QLabel* m_avgSessionLabel; // Average session length
+    QLabel* m_analyticsLabel; // Rolling metrics for the range
 
     // Date range selection
     QComboBox* m_timeRangeCombo; // Time range dropdown
     QDateEdit* m_fromDateEdit; // Custom from date
     QDateEdit* m_toDateEdit; // Custom to date
-    QPushButton* m_refreshButton; // Refresh button
 
     // Activity map
     PomodoroActivityMap* m_activityMap; // Pomodoro activity heatmap
 
+    // Trend chart
+    QComboBox* m_trendMetricCombo; // Pomodoros or minutes
+    QComboBox* m_trendLevelCombo; // Daily or weekly
+    TrendChart* m_trendChart; // Metric and rolling average over the range
+
+    // Per-session interruptions
+    QLabel* m_interruptionSummaryLabel; // Totals for the selected range
+    QTableWidget* m_sessionTable; // One row per work session
+
     // Control buttons
     QHBoxLayout* m_buttonLayout; // Horizontal button arrangement
     QPushButton* m_settingsButton; // Open settings
@@ -97,13 +109,8 @@ private:
     QAction* m_showAction; // Show window action
     QAction* m_quitAction; // Quit application
 
-    // Sound Notification System
-#ifdef HAVE_QT_MULTIMEDIA
-    QMediaPlayer* m_mediaPlayer; // Audio playback component
-#endif
-
     // Core Application Components
-    Timer* m_timer; // Business logic controller
+    SessionController* m_controller; // Owns the timer engine
     Settings* m_settings; // User preferences storage
     DatabaseManager* m_dbManager; // Database manager
 
@@ -111,6 +118,15 @@ private:
     int m_totalTime; // Current timer duration in seconds
     QDate m_fromDate; // Statistics from date
     QDate m_toDate; // Statistics to date
+
+    // Aggregates for the selected range, kept current from sessionRecorded
+    int m_rangePomodoros; // Completed work sessions
+    int m_rangeMinutes; // Sum of whole minutes per day
+    QMap<QDate, int> m_rangeDaySeconds; // Work seconds per day
+    qint64 m_completedSeconds; // Completed work sessions, for the average
+    int m_rangeSessions; // All work sessions
+    SessionTimeline::Summary m_timelineTotal;
+    AnalyticsEngine m_analytics; // 7- and 30-day windows over the range
 };
 
 #endif // ZIGA_POMODORO_MAINWINDOW_H
@@ -0,0 +1,366 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "multitimerengine.h"
+#include <limits>
+
+MultiTimerEngine::MultiTimerEngine(QObject* parent, int resolutionMs)
+    : QObject(parent)
+      , m_driver(new QTimer(this))
+      , m_clockBaseMs(0)
+      , m_autoAdvance(true)
+      , m_advancing(false)
+      , m_resolutionMs(qMax(1, resolutionMs))
+      , m_nowMs(0)
+      , m_activeCount(0)
+{
+    // Plan 0 is always the classic schedule with default durations
+    addPlan(SessionSchedule::classic(4), 25, 5, 15);
+
+    m_clock.start();
+    m_driver->setTimerType(Qt::CoarseTimer);
+    m_driver->setSingleShot(true);
+    connect(m_driver, &QTimer::timeout, this, &MultiTimerEngine::onTick);
+}
+
+MultiTimerEngine::~MultiTimerEngine()
+{
+    m_driver->stop();
+}
+
+int MultiTimerEngine::addPlan(const SessionSchedule& schedule, int workMinutes, int shortBreakMinutes,
+                              int longBreakMinutes)
+{
+    m_plans.push_back(Plan{schedule, workMinutes * 60, shortBreakMinutes * 60, longBreakMinutes * 60});
+    return static_cast<int>(m_plans.size()) - 1;
+}
+
+int MultiTimerEngine::addTimer(int plan)
+{
+    int id;
+    if (!m_freeIds.empty())
+    {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+    }
+    else
+    {
+        id = static_cast<int>(m_timers.size());
+        m_timers.push_back(LogicalTimer{});
+        m_timers.back().generation = 0;
+    }
+
+    LogicalTimer& timer = m_timers[id];
+    timer.handle = TimerWheel::InvalidHandle;
+    timer.completed = 0;
+    timer.plan = static_cast<quint16>(qBound(0, plan, static_cast<int>(m_plans.size()) - 1));
+    timer.step = 0;
+    timer.state = Timer::TimerState::Stopped;
+    timer.inUse = true;
+    timer.timeMs = durationMs(timer);
+
+    m_activeCount++;
+    return id;
+}
+
+void MultiTimerEngine::removeTimer(int id)
+{
+    if (!isValid(id))
+    {
+        return;
+    }
+
+    LogicalTimer& timer = m_timers[id];
+    m_wheel.cancel(timer.handle);
+    timer.handle = TimerWheel::InvalidHandle;
+    timer.inUse = false;
+    timer.generation++;
+
+    m_freeIds.push_back(id);
+    m_activeCount--;
+    scheduleDriver();
+}
+
+int MultiTimerEngine::timerCount() const
+{
+    return m_activeCount;
+}
+
+void MultiTimerEngine::start(int id)
+{
+    if (!isValid(id) || m_timers[id].state == Timer::TimerState::Running)
+    {
+        return;
+    }
+
+    LogicalTimer& timer = m_timers[id];
+    timer.timeMs = currentMs() + timer.timeMs; // Remaining -> deadline
+    timer.handle = m_wheel.arm(toTick(timer.timeMs), static_cast<quint32>(id));
+    timer.state = Timer::TimerState::Running;
+    scheduleDriver();
+    emit stateChanged(id, timer.state);
+}
+
+void MultiTimerEngine::pause(int id)
+{
+    if (!isValid(id) || m_timers[id].state != Timer::TimerState::Running)
+    {
+        return;
+    }
+
+    LogicalTimer& timer = m_timers[id];
+    m_wheel.cancel(timer.handle);
+    timer.handle = TimerWheel::InvalidHandle;
+    timer.timeMs = remainingMs(timer); // Deadline -> remaining
+    timer.state = Timer::TimerState::Paused;
+    scheduleDriver();
+    emit stateChanged(id, timer.state);
+}
+
+void MultiTimerEngine::reset(int id)
+{
+    if (!isValid(id))
+    {
+        return;
+    }
+
+    LogicalTimer& timer = m_timers[id];
+    m_wheel.cancel(timer.handle);
+    timer.handle = TimerWheel::InvalidHandle;
+    timer.state = Timer::TimerState::Stopped;
+    timer.timeMs = durationMs(timer);
+    scheduleDriver();
+    emit stateChanged(id, timer.state);
+}
+
+void MultiTimerEngine::skipToNext(int id)
+{
+    if (!isValid(id))
+    {
+        return;
+    }
+
+    LogicalTimer& timer = m_timers[id];
+    m_wheel.cancel(timer.handle);
+    timer.handle = TimerWheel::InvalidHandle;
+    timer.state = Timer::TimerState::Stopped;
+
+    if (getMode(id) == Timer::TimerMode::Work)
+    {
+        timer.completed++;
+    }
+
+    scheduleDriver();
+    quint32 generation = timer.generation;
+    advanceStep(id);
+    if (isCurrent(id, generation))
+    {
+        emit stateChanged(id, Timer::TimerState::Stopped);
+    }
+}
+
+Timer::TimerState MultiTimerEngine::getState(int id) const
+{
+    return isValid(id) ? m_timers[id].state : Timer::TimerState::Stopped;
+}
+
+Timer::TimerMode MultiTimerEngine::getMode(int id) const
+{
+    if (!isValid(id))
+    {
+        return Timer::TimerMode::Work;
+    }
+
+    const LogicalTimer& timer = m_timers[id];
+    return m_plans[timer.plan].schedule.step(timer.step).mode;
+}
+
+int MultiTimerEngine::getRemainingTime(int id) const
+{
+    if (!isValid(id))
+    {
+        return 0;
+    }
+
+    return static_cast<int>((remainingMs(m_timers[id]) + 999) / 1000);
+}
+
+int MultiTimerEngine::getTotalCompletedPomodoros(int id) const
+{
+    return isValid(id) ? static_cast<int>(m_timers[id].completed) : 0;
+}
+
+void MultiTimerEngine::setAutoAdvance(bool enabled)
+{
+    if (enabled == m_autoAdvance)
+    {
+        return;
+    }
+
+    // Catch up with the wall clock before it stops driving the engine
+    if (!enabled)
+    {
+        advanceTo(currentMs());
+    }
+
+    // Wall-clock time resumes from the engine's current time
+    m_autoAdvance = enabled;
+    m_clockBaseMs = m_nowMs;
+    m_clock.restart();
+    scheduleDriver();
+}
+
+void MultiTimerEngine::advanceTo(qint64 nowMs)
+{
+    if (nowMs <= m_nowMs)
+    {
+        return;
+    }
+
+    m_advancing = true;
+    m_wheel.advance(toTick(nowMs), [this](quint32 id)
+    {
+        // Deadlines fire on their own tick, not at the end of the batch
+        m_nowMs = qMax(m_nowMs, m_wheel.currentTick() * m_resolutionMs);
+        onExpired(id);
+    });
+    m_nowMs = qMax(m_nowMs, nowMs);
+    m_advancing = false;
+
+    scheduleDriver();
+}
+
+qint64 MultiTimerEngine::now() const
+{
+    return currentMs();
+}
+
+int MultiTimerEngine::armedCount() const
+{
+    return m_wheel.size();
+}
+
+void MultiTimerEngine::onTick()
+{
+    advanceTo(currentMs());
+    scheduleDriver(); // Also when a coarse timer fired early and nothing was due
+}
+
+qint64 MultiTimerEngine::currentMs() const
+{
+    return m_autoAdvance ? qMax(m_nowMs, m_clockBaseMs + m_clock.elapsed()) : m_nowMs;
+}
+
+void MultiTimerEngine::scheduleDriver()
+{
+    if (m_advancing)
+    {
+        return;
+    }
+
+    qint64 tick = m_autoAdvance ? m_wheel.nextEventTick() : -1;
+    if (tick < 0)
+    {
+        m_driver->stop(); // Nothing armed: no wakeups at all
+        return;
+    }
+
+    qint64 delayMs = qMax<qint64>(0, tick * m_resolutionMs - currentMs());
+    m_driver->start(static_cast<int>(qMin<qint64>(delayMs, std::numeric_limits<int>::max())));
+}
+
+bool MultiTimerEngine::isValid(int id) const
+{
+    return id >= 0 && id < static_cast<int>(m_timers.size()) && m_timers[id].inUse;
+}
+
+bool MultiTimerEngine::isCurrent(int id, quint32 generation) const
+{
+    return isValid(id) && m_timers[id].generation == generation;
+}
+
+qint64 MultiTimerEngine::remainingMs(const LogicalTimer& timer) const
+{
+    if (timer.state == Timer::TimerState::Running)
+    {
+        return qMax<qint64>(0, timer.timeMs - currentMs());
+    }
+
+    return timer.timeMs;
+}
+
+qint64 MultiTimerEngine::durationMs(const LogicalTimer& timer) const
+{
+    const Plan& plan = m_plans[timer.plan];
+    const ScheduleStep& step = plan.schedule.step(timer.step);
+
+    if (step.minutes > 0)
+    {
+        return step.minutes * 60000LL;
+    }
+
+    switch (step.mode)
+    {
+    case Timer::TimerMode::ShortBreak:
+        return plan.shortBreakDuration * 1000LL;
+    case Timer::TimerMode::LongBreak:
+        return plan.longBreakDuration * 1000LL;
+    case Timer::TimerMode::Work:
+    default:
+        return plan.workDuration * 1000LL;
+    }
+}
+
+qint64 MultiTimerEngine::toTick(qint64 ms) const
+{
+    // Round up so a deadline never fires before its time
+    return (ms + m_resolutionMs - 1) / m_resolutionMs;
+}
+
+void MultiTimerEngine::onExpired(quint32 id)
+{
+    if (!isValid(static_cast<int>(id)))
+    {
+        return;
+    }
+
+    LogicalTimer& timer = m_timers[id];
+    timer.handle = TimerWheel::InvalidHandle;
+    timer.state = Timer::TimerState::Stopped;
+
+    Timer::TimerMode completedMode = getMode(static_cast<int>(id));
+    if (completedMode == Timer::TimerMode::Work)
+    {
+        timer.completed++;
+    }
+
+    // Move on before anyone hears about it, so a handler that restarts the
+    // timer gets the next step's full duration
+    quint32 generation = timer.generation;
+    advanceStep(static_cast<int>(id));
+
+    // Each handler may remove the timer, and a later addTimer() may reuse the id
+    if (isCurrent(static_cast<int>(id), generation))
+    {
+        emit stateChanged(static_cast<int>(id), Timer::TimerState::Stopped);
+    }
+    if (isCurrent(static_cast<int>(id), generation))
+    {
+        emit timerCompleted(static_cast<int>(id), completedMode);
+    }
+}
+
+void MultiTimerEngine::advanceStep(int id)
+{
+    LogicalTimer& timer = m_timers[id];
+    Timer::TimerMode previousMode = getMode(id);
+
+    timer.step = static_cast<quint8>(m_plans[timer.plan].schedule.next(timer.step));
+    timer.timeMs = durationMs(timer);
+
+    if (getMode(id) != previousMode)
+    {
+        emit modeChanged(id, getMode(id));
+    }
+}
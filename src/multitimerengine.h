@@ -0,0 +1,112 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_MULTITIMERENGINE_H
+#define ZIGA_POMODORO_MULTITIMERENGINE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <vector>
+
+#include "timer.h"
+#include "timerwheel.h"
+
+// Drives many logical pomodoro timers from one thread. Each timer is a small
+// state machine following a shared SessionSchedule; deadlines live in a
+// TimerWheel so arming and cancelling stay O(1) regardless of the count.
+// The real-time driver is a single-shot timer armed for the wheel's next
+// event, so with nothing running the engine never wakes up.
+//
+// A completed timer has already moved on to its next step when
+// timerCompleted is emitted, so handlers may start it right away.
+class MultiTimerEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MultiTimerEngine(QObject* parent = nullptr, int resolutionMs = 100);
+    ~MultiTimerEngine() override;
+
+    // Plans are shared by timers; durations apply to steps without their own length
+    int addPlan(const SessionSchedule& schedule, int workMinutes, int shortBreakMinutes, int longBreakMinutes);
+
+    int addTimer(int plan = 0);
+    void removeTimer(int id);
+    int timerCount() const;
+
+    void start(int id);
+    void pause(int id);
+    void reset(int id);
+    void skipToNext(int id);
+
+    Timer::TimerState getState(int id) const;
+    Timer::TimerMode getMode(int id) const;
+    int getRemainingTime(int id) const;
+    int getTotalCompletedPomodoros(int id) const;
+
+    // Drives the wheel from wall-clock time (the default)
+    void setAutoAdvance(bool enabled);
+
+    // Moves engine time forward, firing every deadline on the way. Used by
+    // harnesses that want to run without waiting on wall-clock time.
+    void advanceTo(qint64 nowMs);
+    qint64 now() const;
+
+    int armedCount() const; // Timers with a deadline in the wheel
+
+signals:
+    void timerCompleted(int id, Timer::TimerMode completedMode);
+    void modeChanged(int id, Timer::TimerMode newMode);
+    void stateChanged(int id, Timer::TimerState newState);
+
+private slots:
+    void onTick();
+
+private:
+    struct Plan
+    {
+        SessionSchedule schedule;
+        int workDuration;
+        int shortBreakDuration;
+        int longBreakDuration;
+    };
+
+    struct LogicalTimer
+    {
+        TimerWheel::Handle handle;
+        qint64 timeMs; // Deadline while running, remaining time otherwise
+        quint32 completed;
+        quint32 generation; // Bumped when the id is freed, so a recycled id is told apart
+        quint16 plan;
+        quint8 step;
+        Timer::TimerState state;
+        bool inUse;
+    };
+
+    QTimer* m_driver; // Single shot, armed for the wheel's next event
+    QElapsedTimer m_clock;
+    qint64 m_clockBaseMs; // Engine time when m_clock was started
+    bool m_autoAdvance;
+    bool m_advancing; // Inside advanceTo(); the driver is rescheduled once at the end
+    int m_resolutionMs;
+    qint64 m_nowMs; // Time the wheel has been advanced to
+    TimerWheel m_wheel;
+    std::vector<Plan> m_plans;
+    std::vector<LogicalTimer> m_timers;
+    std::vector<int> m_freeIds;
+    int m_activeCount;
+
+    bool isValid(int id) const;
+    bool isCurrent(int id, quint32 generation) const;
+    qint64 currentMs() const;
+    void scheduleDriver();
+    qint64 remainingMs(const LogicalTimer& timer) const;
+    qint64 durationMs(const LogicalTimer& timer) const;
+    qint64 toTick(qint64 ms) const;
+    void onExpired(quint32 id);
+    void advanceStep(int id);
+};
+
+#endif // ZIGA_POMODORO_MULTITIMERENGINE_H
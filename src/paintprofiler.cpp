@@ -0,0 +1,264 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "paintprofiler.h"
+#include "paintstatsoverlay.h"
+#include <QTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QDebug>
+
+namespace
+{
+// Upper bound of each histogram bucket in nanoseconds; the last is open-ended
+constexpr qint64 kBucketLimits[DurationHistogram::kBucketCount - 1] = {
+    250000, 500000, 1000000, 2000000, 4000000, 8000000, 16000000
+};
+
+double toMs(qint64 nanos)
+{
+    return nanos / 1000000.0;
+}
+}
+
+void DurationHistogram::add(qint64 nanos)
+{
+    int bucket = 0;
+    while (bucket < kBucketCount - 1 && nanos >= kBucketLimits[bucket])
+    {
+        bucket++;
+    }
+    counts[bucket]++;
+    samples++;
+    totalNanos += nanos;
+    maxNanos = qMax(maxNanos, nanos);
+}
+
+QJsonObject DurationHistogram::toJson() const
+{
+    QJsonArray limits;
+    for (qint64 limit : kBucketLimits)
+    {
+        limits.append(toMs(limit));
+    }
+
+    QJsonArray bucketCounts;
+    for (int count : counts)
+    {
+        bucketCounts.append(count);
+    }
+
+    QJsonObject json;
+    json["samples"] = samples;
+    json["totalMs"] = toMs(totalNanos);
+    json["meanMs"] = samples > 0 ? toMs(totalNanos) / samples : 0.0;
+    json["maxMs"] = toMs(maxNanos);
+    json["bucketUpperBoundsMs"] = limits;
+    json["bucketCounts"] = bucketCounts;
+    return json;
+}
+
+PaintStats::PaintStats(const QString& name)
+    : m_name(name)
+{
+}
+
+void PaintStats::recordPaint(const QRegion& region, qint64 nanos)
+{
+    qint64 area = 0;
+    for (const QRect& rect : region)
+    {
+        area += qint64(rect.width()) * rect.height();
+    }
+
+    m_durations.add(nanos);
+    m_invalidatedArea += area;
+    m_lastArea = area;
+}
+
+void PaintStats::reset()
+{
+    m_durations = DurationHistogram();
+    m_invalidatedArea = 0;
+    m_lastArea = 0;
+}
+
+QString PaintStats::name() const
+{
+    return m_name;
+}
+
+const DurationHistogram& PaintStats::durations() const
+{
+    return m_durations;
+}
+
+qint64 PaintStats::invalidatedArea() const
+{
+    return m_invalidatedArea;
+}
+
+qint64 PaintStats::lastArea() const
+{
+    return m_lastArea;
+}
+
+QJsonObject PaintStats::toJson() const
+{
+    QJsonObject json;
+    json["name"] = m_name;
+    json["paints"] = m_durations.samples;
+    json["invalidatedPixels"] = double(m_invalidatedArea);
+    json["meanInvalidatedPixels"] = m_durations.samples > 0
+                                        ? double(m_invalidatedArea) / m_durations.samples
+                                        : 0.0;
+    json["durations"] = m_durations.toJson();
+    return json;
+}
+
+QString PaintStats::summary() const
+{
+    double mean = m_durations.samples > 0 ? toMs(m_durations.totalNanos) / m_durations.samples : 0.0;
+    return QString("%1: %2 paints, mean %3 ms, max %4 ms, last %5 px")
+           .arg(m_name)
+           .arg(m_durations.samples)
+           .arg(mean, 0, 'f', 3)
+           .arg(toMs(m_durations.maxNanos), 0, 'f', 3)
+           .arg(m_lastArea);
+}
+
+PaintScope::PaintScope(PaintStats* stats, const QRegion& region)
+    : m_stats(stats)
+{
+    if (m_stats)
+    {
+        m_region = region;
+        m_timer.start();
+    }
+}
+
+PaintScope::~PaintScope()
+{
+    if (m_stats)
+    {
+        m_stats->recordPaint(m_region, m_timer.nsecsElapsed());
+    }
+}
+
+PaintProfiler::PaintProfiler(QObject* parent)
+    : QObject(parent)
+      , m_heartbeat(new QTimer(this))
+      , m_overlay(nullptr)
+{
+    m_uptime.start();
+    m_sinceHeartbeat.start();
+
+    m_heartbeat->setTimerType(Qt::PreciseTimer);
+    m_heartbeat->setInterval(kHeartbeatInterval);
+    connect(m_heartbeat, &QTimer::timeout, this, &PaintProfiler::onHeartbeat);
+    m_heartbeat->start();
+}
+
+PaintProfiler::~PaintProfiler()
+{
+    delete m_overlay;
+    qDeleteAll(m_stats);
+}
+
+PaintStats* PaintProfiler::statsFor(const QString& name)
+{
+    for (PaintStats* stats : m_stats)
+    {
+        if (stats->name() == name)
+        {
+            return stats;
+        }
+    }
+
+    PaintStats* stats = new PaintStats(name);
+    m_stats.append(stats);
+    return stats;
+}
+
+QList<PaintStats*> PaintProfiler::allStats() const
+{
+    return m_stats;
+}
+
+const DurationHistogram& PaintProfiler::eventLoopLatency() const
+{
+    return m_latency;
+}
+
+void PaintProfiler::setOverlayVisible(bool visible)
+{
+    if (visible == isOverlayVisible())
+    {
+        return;
+    }
+
+    if (visible && !m_overlay)
+    {
+        m_overlay = new PaintStatsOverlay(this);
+    }
+    m_overlay->setVisible(visible);
+
+    emit overlayVisibilityChanged(visible);
+}
+
+bool PaintProfiler::isOverlayVisible() const
+{
+    return m_overlay && m_overlay->isVisible();
+}
+
+QJsonDocument PaintProfiler::toJson() const
+{
+    QJsonArray widgets;
+    for (const PaintStats* stats : m_stats)
+    {
+        widgets.append(stats->toJson());
+    }
+
+    QJsonObject eventLoop = m_latency.toJson();
+    eventLoop["heartbeatIntervalMs"] = kHeartbeatInterval;
+
+    QJsonObject root;
+    root["capturedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODateWithMs);
+    root["uptimeMs"] = double(m_uptime.elapsed());
+    root["widgets"] = widgets;
+    root["eventLoopLatency"] = eventLoop;
+    return QJsonDocument(root);
+}
+
+bool PaintProfiler::exportJson(const QString& filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        qWarning() << "Failed to write paint statistics to" << filePath << ":" << file.errorString();
+        return false;
+    }
+
+    file.write(toJson().toJson(QJsonDocument::Indented));
+    return true;
+}
+
+void PaintProfiler::reset()
+{
+    for (PaintStats* stats : m_stats)
+    {
+        stats->reset();
+    }
+    m_latency = DurationHistogram();
+    m_sinceHeartbeat.restart();
+}
+
+void PaintProfiler::onHeartbeat()
+{
+    // How much later than scheduled the event loop got round to us
+    qint64 lateness = m_sinceHeartbeat.nsecsElapsed() - qint64(kHeartbeatInterval) * 1000000;
+    m_sinceHeartbeat.restart();
+    m_latency.add(qMax<qint64>(0, lateness));
+}
@@ -0,0 +1,109 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_PAINTPROFILER_H
+#define ZIGA_POMODORO_PAINTPROFILER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QRegion>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+class QTimer;
+class PaintStatsOverlay;
+
+// Durations bucketed by powers of two, from under 0.25 ms to 16 ms and over
+struct DurationHistogram
+{
+    static constexpr int kBucketCount = 8;
+
+    int counts[kBucketCount] = {};
+    int samples = 0;
+    qint64 totalNanos = 0;
+    qint64 maxNanos = 0;
+
+    void add(qint64 nanos);
+    QJsonObject toJson() const;
+};
+
+// Paint statistics for one widget
+class PaintStats
+{
+public:
+    explicit PaintStats(const QString& name);
+
+    void recordPaint(const QRegion& region, qint64 nanos);
+    void reset();
+
+    QString name() const;
+    const DurationHistogram& durations() const;
+    qint64 invalidatedArea() const; // Sum of all painted regions, in logical pixels
+    qint64 lastArea() const;
+
+    QJsonObject toJson() const;
+    QString summary() const; // One line for the overlay
+
+private:
+    QString m_name;
+    DurationHistogram m_durations;
+    qint64 m_invalidatedArea = 0;
+    qint64 m_lastArea = 0;
+};
+
+// Times one paintEvent; does nothing when stats is null, so widgets can
+// keep it in place whether or not profiling is on
+class PaintScope
+{
+public:
+    PaintScope(PaintStats* stats, const QRegion& region);
+    ~PaintScope();
+
+private:
+    PaintStats* m_stats;
+    QRegion m_region;
+    QElapsedTimer m_timer;
+};
+
+// Opt-in (--paint-stats) registry of per-widget paint statistics plus an
+// event-loop latency probe: a precise heartbeat whose lateness is recorded
+class PaintProfiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PaintProfiler(QObject* parent = nullptr);
+    ~PaintProfiler() override;
+
+    PaintStats* statsFor(const QString& name); // Created on first use
+    QList<PaintStats*> allStats() const;
+    const DurationHistogram& eventLoopLatency() const;
+
+    void setOverlayVisible(bool visible);
+    bool isOverlayVisible() const;
+
+    QJsonDocument toJson() const;
+    bool exportJson(const QString& filePath) const;
+    void reset();
+
+signals:
+    void overlayVisibilityChanged(bool visible);
+
+private slots:
+    void onHeartbeat();
+
+private:
+    static constexpr int kHeartbeatInterval = 50; // ms
+
+    QList<PaintStats*> m_stats;
+    QTimer* m_heartbeat;
+    QElapsedTimer m_sinceHeartbeat;
+    QElapsedTimer m_uptime;
+    DurationHistogram m_latency;
+    PaintStatsOverlay* m_overlay;
+};
+
+#endif // ZIGA_POMODORO_PAINTPROFILER_H
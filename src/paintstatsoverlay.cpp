@@ -0,0 +1,95 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "paintstatsoverlay.h"
+#include "paintprofiler.h"
+#include <QPainter>
+#include <QTimer>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QApplication>
+#include <QScreen>
+
+PaintStatsOverlay::PaintStatsOverlay(PaintProfiler* profiler)
+    : QWidget(nullptr)
+      , m_profiler(profiler)
+      , m_refreshTimer(new QTimer(this))
+{
+    setWindowFlags(Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::Tool
+        | Qt::WindowTransparentForInput);
+    setAttribute(Qt::WA_TranslucentBackground);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_ShowWithoutActivating);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    // Twice a second is plenty for reading and keeps the overlay cheap
+    m_refreshTimer->setInterval(500);
+    connect(m_refreshTimer, &QTimer::timeout, this, &PaintStatsOverlay::refresh);
+}
+
+void PaintStatsOverlay::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    refresh();
+    m_refreshTimer->start();
+}
+
+void PaintStatsOverlay::hideEvent(QHideEvent* event)
+{
+    m_refreshTimer->stop();
+    QWidget::hideEvent(event);
+}
+
+void PaintStatsOverlay::refresh()
+{
+    m_lines.clear();
+    for (const PaintStats* stats : m_profiler->allStats())
+    {
+        m_lines << stats->summary();
+    }
+
+    const DurationHistogram& latency = m_profiler->eventLoopLatency();
+    m_lines << QString("Event loop: mean %1 ms, max %2 ms late")
+               .arg(latency.samples > 0 ? latency.totalNanos / 1e6 / latency.samples : 0.0, 0, 'f', 3)
+               .arg(latency.maxNanos / 1e6, 0, 'f', 3);
+
+    // Size to the text and sit in the top-left corner of the primary screen
+    QFontMetrics metrics(font());
+    int textWidth = 0;
+    for (const QString& line : m_lines)
+    {
+        textWidth = qMax(textWidth, metrics.horizontalAdvance(line));
+    }
+    QSize size(textWidth + 16, m_lines.size() * metrics.lineSpacing() + 12);
+    if (size != this->size())
+    {
+        resize(size);
+        if (QScreen* screen = QApplication::primaryScreen())
+        {
+            move(screen->availableGeometry().topLeft() + QPoint(8, 8));
+        }
+    }
+
+    update();
+}
+
+void PaintStatsOverlay::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 190));
+    painter.drawRoundedRect(rect(), 6, 6);
+
+    painter.setPen(Qt::white);
+    QFontMetrics metrics(font());
+    int y = 6 + metrics.ascent();
+    for (const QString& line : m_lines)
+    {
+        painter.drawText(8, y, line);
+        y += metrics.lineSpacing();
+    }
+}
@@ -0,0 +1,38 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_PAINTSTATSOVERLAY_H
+#define ZIGA_POMODORO_PAINTSTATSOVERLAY_H
+
+#include <QWidget>
+#include <QStringList>
+
+class QTimer;
+class PaintProfiler;
+
+// Click-through always-on-top panel listing the profiler's live numbers.
+// It is a separate window so its own repaints never land in the statistics
+// of the widgets it reports on.
+class PaintStatsOverlay : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PaintStatsOverlay(PaintProfiler* profiler);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+
+private slots:
+    void refresh();
+
+private:
+    PaintProfiler* m_profiler;
+    QTimer* m_refreshTimer;
+    QStringList m_lines;
+};
+
+#endif // ZIGA_POMODORO_PAINTSTATSOVERLAY_H
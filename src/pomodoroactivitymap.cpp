@@ -3,24 +3,44 @@
 //
 
 #include "pomodoroactivitymap.h"
+#include "trace.h"
 #include "databasemanager.h"
+#include "paintprofiler.h"
 #include <QPainter>
 #include <QToolTip>
 #include <QDateTime>
+#include <QScrollBar>
+#include <QWheelEvent>
+
+namespace
+{
+// Columns per background query
+constexpr int kChunkColumns = 8;
+}
 
 PomodoroActivityMap::PomodoroActivityMap(QWidget* parent)
     : QWidget(parent)
       , m_dbManager(nullptr)
-      , m_cellSize(18)
-      , m_cellSpacing(3)
-      , m_maxPomodoros(0)
+      , m_paintStats(nullptr)
+      , m_autoGranularity(true)
+      , m_loader(new ActivityLoader(this))
+      , m_requestId(0)
+      , m_maximumPending(true)
+      , m_scrollBar(new QScrollBar(Qt::Horizontal, this))
+      , m_hoverIndex(-1)
+      , m_backingValid(false)
 {
     setMouseTracking(true);
-    setMinimumHeight(150);
+    setMinimumHeight(240);
+
+    connect(m_scrollBar, &QScrollBar::valueChanged, this, &PomodoroActivityMap::onScrolled);
+    connect(m_loader, &ActivityLoader::chunkLoaded, this, &PomodoroActivityMap::onChunkLoaded);
+    connect(m_loader, &ActivityLoader::maximumLoaded, this, &PomodoroActivityMap::onMaximumLoaded);
 
     // Default to the last 3 months
-    m_startDate = QDate::currentDate().addMonths(-3);
-    m_endDate = QDate::currentDate();
+    QDate today = Clock::instance()->currentDate();
+    m_renderer.setDateRange(today.addMonths(-3), today, ActivityGranularity::Day);
+    resetColumns(ActivityGranularity::Day);
 }
 
 PomodoroActivityMap::~PomodoroActivityMap() = default;
@@ -28,260 +48,485 @@ PomodoroActivityMap::~PomodoroActivityMap() = default;
 void PomodoroActivityMap::setDatabaseManager(DatabaseManager* dbManager)
 {
     m_dbManager = dbManager;
+
+    // The loader reads through its own connection on its own thread
+    m_loader->setDatabasePath(dbManager && dbManager->isInitialized() ? dbManager->getDatabasePath() : QString());
     refreshData();
 }
 
+void PomodoroActivityMap::setPaintStats(PaintStats* stats)
+{
+    m_paintStats = stats;
+}
+
 void PomodoroActivityMap::setDateRange(const QDate& startDate, const QDate& endDate)
 {
-    m_startDate = startDate;
-    m_endDate = endDate;
+    ActivityGranularity granularity = m_renderer.granularity();
+    if (m_autoGranularity)
+    {
+        granularity = ActivityMapRenderer::autoGranularity(
+            startDate, endDate, width() - m_renderer.gridLeft() - m_renderer.gridRightMargin());
+    }
+
+    m_renderer.setDateRange(startDate, endDate, granularity);
+    resetColumns(granularity);
     refreshData();
 }
 
-void PomodoroActivityMap::refreshData()
+ActivityGranularity PomodoroActivityMap::getGranularity() const
 {
-    if (!m_dbManager)
+    return m_renderer.granularity();
+}
+
+void PomodoroActivityMap::setGranularity(ActivityGranularity granularity)
+{
+    m_autoGranularity = false;
+    if (granularity == m_renderer.granularity())
     {
         return;
     }
 
-    // Clear previous data
-    m_pomodorosByDate.clear();
-    m_minutesByDate.clear();
-    m_maxPomodoros = 0;
+    resetColumns(granularity);
+    refreshData();
+}
 
-    // Fetch data from database
-    QList<QPair<QDate, int>> dailyStats = m_dbManager->getDailyPomodoroStats(m_startDate, m_endDate);
+int PomodoroActivityMap::getLoadedBucketCount() const
+{
+    return m_renderer.windowSize();
+}
 
-    for (const auto& stat : dailyStats)
+bool PomodoroActivityMap::isLoading() const
+{
+    if (!m_loader->hasDatabase() || m_renderer.columnCount() == 0)
     {
-        m_pomodorosByDate[stat.first] = stat.second;
-        m_maxPomodoros = qMax(m_maxPomodoros, stat.second);
+        return false;
+    }
 
-        // Get total minutes for this day
-        int minutes = m_dbManager->getTotalWorkMinutes(stat.first);
-        m_minutesByDate[stat.first] = minutes;
+    if (m_maximumPending)
+    {
+        return true;
     }
 
-    // Make sure we have a non-zero max for color scaling
-    if (m_maxPomodoros == 0)
+    int first = m_renderer.firstBucketOfColumn(m_renderer.firstColumn());
+    int last = m_renderer.lastBucketOfColumn(m_renderer.lastVisibleColumn());
+    for (int bucket = first; bucket <= last; bucket++)
     {
-        m_maxPomodoros = 1;
+        if (m_renderer.pomodorosAt(bucket) < 0)
+        {
+            return true;
+        }
     }
+    return false;
+}
 
-    calculateCellPositions();
-    update();
+void PomodoroActivityMap::refreshData()
+{
+    // Drop the loaded window and anything still in flight; skeleton cells
+    // show until the new chunks arrive
+    m_renderer.setWindow(0, QVector<int>(), QVector<int>());
+    m_hoverIndex = -1;
+    m_maximumPending = true;
+
+    ensureLoaded(true);
+    invalidateBackingImage();
 }
 
-void PomodoroActivityMap::paintEvent(QPaintEvent* event)
+void PomodoroActivityMap::resetColumns(ActivityGranularity granularity)
 {
-    Q_UNUSED(event);
+    m_renderer.setDateRange(m_renderer.startDate(), m_renderer.endDate(), granularity);
+
+    // Start scrolled to the most recent columns
+    m_scrollBar->blockSignals(true);
+    updateScrollRange();
+    m_scrollBar->setValue(m_scrollBar->maximum());
+    m_scrollBar->blockSignals(false);
+    m_renderer.setViewport(m_scrollBar->value(), width());
+    m_hoverIndex = -1;
+}
 
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+void PomodoroActivityMap::updateScrollRange()
+{
+    int visible = m_renderer.visibleColumnCount(width());
+    int maxFirst = qMax(0, m_renderer.columnCount() - visible);
+    m_scrollBar->setRange(0, maxFirst); // Clamps the value, scrolling if needed
+    m_scrollBar->setPageStep(visible);
+    m_scrollBar->setVisible(maxFirst > 0);
+    m_renderer.setViewport(m_scrollBar->value(), width());
+}
 
-    // Draw month labels
-    QFont monthFont = font();
-    monthFont.setPointSize(9);
-    painter.setFont(monthFont);
+void PomodoroActivityMap::ensureLoaded(bool force)
+{
+    if (!m_dbManager || m_renderer.columnCount() == 0)
+    {
+        return;
+    }
 
-    QDate date = m_startDate;
-    int currentMonth = -1;
-    int monthLabelY = 15;
+    int visible = m_renderer.visibleColumnCount();
+    int firstColumn = m_renderer.firstColumn();
+    int lastColumn = m_renderer.lastVisibleColumn();
+    int first = m_renderer.firstBucketOfColumn(firstColumn);
+    int last = m_renderer.lastBucketOfColumn(lastColumn);
 
-    while (date <= m_endDate)
+    int loadedFirst = m_renderer.windowFirst();
+    if (!force && first >= loadedFirst && last < loadedFirst + m_renderer.windowSize())
     {
-        if (date.month() != currentMonth)
-        {
-            currentMonth = date.month();
-            int dayOfWeek = date.dayOfWeek();
-            int x = 50 + ((date.daysTo(m_startDate) * -1) / 7) * (m_cellSize + m_cellSpacing);
+        return;
+    }
 
-            QString monthName = QLocale().monthName(date.month(), QLocale::ShortFormat);
-            painter.drawText(x, monthLabelY, monthName);
-        }
-        date = date.addDays(1);
+    // Hold a page either side so short scrolls need no new requests
+    int windowFirst = m_renderer.firstBucketOfColumn(qMax(0, firstColumn - visible));
+    int windowLast = m_renderer.lastBucketOfColumn(qMin(m_renderer.columnCount() - 1, lastColumn + visible));
+
+    // Keep whatever the old window already has; the rest reads as loading
+    QVector<int> pomodoros(windowLast - windowFirst + 1);
+    QVector<int> seconds(windowLast - windowFirst + 1);
+    for (int bucket = windowFirst; bucket <= windowLast; bucket++)
+    {
+        pomodoros[bucket - windowFirst] = m_renderer.pomodorosAt(bucket);
+        seconds[bucket - windowFirst] = m_renderer.secondsAt(bucket);
+    }
+
+    // Nothing will ever arrive without a database: show empty cells
+    if (!m_loader->hasDatabase())
+    {
+        pomodoros.fill(0);
+        m_maximumPending = false;
     }
 
-    // Draw weekday labels
-    QFont dayFont = font();
-    dayFont.setPointSize(8);
-    painter.setFont(dayFont);
+    m_renderer.setWindow(windowFirst, pomodoros, seconds);
 
-    QStringList dayNames = {"Mon", "Wed", "Fri"};
-    for (int i = 0; i < dayNames.size(); i++)
+    if (m_loader->hasDatabase())
     {
-        int dayIndex = i * 2; // 0, 2, 4 for Mon, Wed, Fri
-        int y = 35 + dayIndex * (m_cellSize + m_cellSpacing) + m_cellSize / 2;
-        painter.drawText(15, y + 4, dayNames[i]);
+        requestPending(firstColumn, lastColumn);
     }
+}
 
-    // Draw cells
-    for (const auto& cell : m_cells)
+void PomodoroActivityMap::requestPending(int visibleFirstColumn, int visibleLastColumn)
+{
+    int windowFirstColumn = m_renderer.columnOfBucket(m_renderer.windowFirst());
+    int windowLastColumn = m_renderer.columnOfBucket(m_renderer.windowFirst() + m_renderer.windowSize() - 1);
+
+    // Visible columns first, newest to oldest, then the newer margin, then the older one
+    QVector<QPair<int, int>> spans;
+    for (int column = visibleLastColumn; column >= visibleFirstColumn; column -= kChunkColumns)
     {
-        QColor cellColor = getColorForCount(cell.count);
+        spans.append({qMax(visibleFirstColumn, column - kChunkColumns + 1), column});
+    }
+    for (int column = visibleLastColumn + 1; column <= windowLastColumn; column += kChunkColumns)
+    {
+        spans.append({column, qMin(windowLastColumn, column + kChunkColumns - 1)});
+    }
+    for (int column = visibleFirstColumn - 1; column >= windowFirstColumn; column -= kChunkColumns)
+    {
+        spans.append({qMax(windowFirstColumn, column - kChunkColumns + 1), column});
+    }
 
-        // Highlight the cell being hovered
-        if (cell.date == m_currentHoverDate)
+    QVector<ActivityLoader::Chunk> chunks;
+    for (const auto& span : spans)
+    {
+        int first = m_renderer.firstBucketOfColumn(span.first);
+        int last = m_renderer.lastBucketOfColumn(span.second);
+
+        bool pending = false;
+        for (int bucket = first; bucket <= last && !pending; bucket++)
         {
-            painter.setPen(QPen(Qt::black, 1));
+            pending = m_renderer.pomodorosAt(bucket) < 0;
         }
-        else
+
+        if (pending)
         {
-            painter.setPen(QPen(cellColor.darker(110), 1));
+            chunks.append({qMax(m_renderer.bucketStart(first), m_renderer.startDate()),
+                           qMin(m_renderer.bucketStart(last + 1).addDays(-1), m_renderer.endDate())});
         }
-
-        painter.setBrush(cellColor);
-        painter.drawRoundedRect(cell.rect, 2, 2);
     }
 
-    // Draw the legend
-    drawLegend(painter);
+    // Also supersedes whatever the previous window still had queued
+    m_requestId = m_loader->request(m_renderer.granularity(), m_renderer.startDate(), m_renderer.endDate(),
+                                    chunks, m_maximumPending);
 }
 
-void PomodoroActivityMap::mouseMoveEvent(QMouseEvent* event)
+void PomodoroActivityMap::onChunkLoaded(quint64 requestId, const QDate& from, const QDate& to,
+                                        const QList<ActivityBucket>& buckets)
 {
-    CellInfo* cell = getCellAt(event->pos());
-
-    if (cell)
+    if (requestId != m_requestId)
     {
-        m_currentHoverDate = cell->date;
-        update();
+        return;
+    }
 
-        QString toolTipText = QString("%1\n%2 pomodoros\n%3 minutes")
-                              .arg(cell->date.toString("MMM d, yyyy"))
-                              .arg(cell->count)
-                              .arg(cell->minutes);
-        QToolTip::showText(event->globalPos(), toolTipText, this, cell->rect);
+    // Buckets without sessions are not returned, so the whole chunk starts at zero
+    int first = m_renderer.bucketForDate(from);
+    int last = m_renderer.bucketForDate(to);
+    for (int bucket = first; bucket <= last; bucket++)
+    {
+        m_renderer.setBucket(bucket, 0, 0);
     }
-    else if (!m_legendRect.contains(event->pos()))
+
+    for (const ActivityBucket& activity : buckets)
     {
-        m_currentHoverDate = QDate();
-        update();
-        QToolTip::hideText();
+        m_renderer.setBucket(m_renderer.bucketForDate(activity.start), activity.pomodoros, activity.seconds);
     }
 
-    QWidget::mouseMoveEvent(event);
+    repaintBuckets(first, last);
 }
 
-void PomodoroActivityMap::leaveEvent(QEvent* event)
+void PomodoroActivityMap::onMaximumLoaded(quint64 requestId, int maximum)
 {
-    m_currentHoverDate = QDate();
-    update();
-    QToolTip::hideText();
+    if (requestId != m_requestId)
+    {
+        return;
+    }
 
-    QWidget::leaveEvent(event);
+    // The colour scale spans the whole range so it stays put while scrolling
+    m_maximumPending = false;
+    m_renderer.setMaximum(maximum);
+    invalidateBackingImage();
 }
 
-void PomodoroActivityMap::calculateCellPositions()
+void PomodoroActivityMap::onSessionRecorded(const RecordedSession& session)
 {
-    m_cells.clear();
+    QDate date = session.record.startTime.date();
+    if (session.kind != RecordedSession::Kind::Work || date < m_renderer.startDate() || date > m_renderer.endDate())
+    {
+        return;
+    }
 
-    // Determine the number of weeks to display
-    int totalDays = m_startDate.daysTo(m_endDate) + 1;
-    int totalWeeks = (totalDays + 6) / 7; // Ceiling division
+    // Not loaded yet: the query that loads it will read the committed row
+    int bucket = m_renderer.bucketForDate(date);
+    int pomodoros = m_renderer.pomodorosAt(bucket);
+    if (pomodoros < 0)
+    {
+        return;
+    }
 
-    // Adjust the widget width based on cell size and number of weeks
-    int mapWidth = 50 + (totalWeeks * (m_cellSize + m_cellSpacing));
-    setMinimumWidth(mapWidth + 100); // Add space for legend
+    pomodoros += session.record.completed ? 1 : 0;
+    m_renderer.setBucket(bucket, pomodoros, m_renderer.secondsAt(bucket) + session.record.durationSeconds);
 
-    // Create cells for each date in the range
-    QDate date = m_startDate;
-    while (date <= m_endDate)
+    // A new busiest bucket rescales every colour; otherwise one cell changes
+    if (!m_maximumPending && pomodoros > m_renderer.maximum())
     {
-        int dayOfWeek = date.dayOfWeek() % 7; // 0-6 (Sunday = 0, Monday = 1, etc.)
-        if (dayOfWeek == 0) dayOfWeek = 7; // Adjust to make Monday = 1, Sunday = 7
+        m_renderer.setMaximum(pomodoros);
+        invalidateBackingImage();
+    }
+    else
+    {
+        repaintBuckets(bucket, bucket);
+    }
+}
 
-        int weekIndex = m_startDate.daysTo(date) / 7;
+void PomodoroActivityMap::onScrolled(int firstColumn)
+{
+    m_renderer.setViewport(firstColumn, width());
+    m_hoverIndex = -1;
+    ensureLoaded();
+    invalidateBackingImage();
+}
 
-        int x = 50 + weekIndex * (m_cellSize + m_cellSpacing);
-        int y = 35 + (dayOfWeek - 1) * (m_cellSize + m_cellSpacing);
+void PomodoroActivityMap::paintEvent(QPaintEvent* event)
+{
+    ZP_TRACE_SCOPE("paint", "PomodoroActivityMap::paintEvent");
 
-        QRect cellRect(x, y, m_cellSize, m_cellSize);
+    PaintScope profile(m_paintStats, event->region());
 
-        CellInfo cell;
-        cell.rect = cellRect;
-        cell.date = date;
-        cell.count = m_pomodorosByDate.value(date, 0);
-        cell.minutes = m_minutesByDate.value(date, 0);
+    ensureBackingImage();
 
-        m_cells.append(cell);
+    QPainter painter(this);
+    painter.drawImage(event->rect(), m_backingImage,
+                      QRectF(QPointF(event->rect().topLeft()) * m_backingImage.devicePixelRatio(),
+                             QSizeF(event->rect().size()) * m_backingImage.devicePixelRatio()));
 
-        date = date.addDays(1);
+    // Highlight the cell being hovered
+    if (m_hoverIndex >= 0)
+    {
+        QRect rect = m_renderer.cellRect(m_hoverIndex);
+        if (event->rect().intersects(rect.adjusted(-1, -1, 1, 1)))
+        {
+            int count = m_renderer.pomodorosAt(m_hoverIndex);
+            painter.setRenderHint(QPainter::Antialiasing);
+            painter.setPen(QPen(Qt::black, 1));
+            painter.setBrush(count < 0 ? ActivityMapRenderer::skeletonColor() : m_renderer.colorForCount(count));
+            painter.drawRoundedRect(rect, 2, 2);
+        }
     }
-
-    // Position the legend
-    m_legendRect = QRect(width() - 240, height() - 40, 200, 30);
 }
 
-QColor PomodoroActivityMap::getColorForCount(int count) const
+void PomodoroActivityMap::repaintBuckets(int first, int last)
 {
-    if (count == 0)
+    if (m_renderer.columnCount() == 0)
     {
-        return QColor(238, 238, 238); // Light gray for zero
+        return;
     }
 
-    // Set a minimum intensity level for non-zero values
-    // This ensures even small counts have a visible color
-    int minIntensity = 50; // Adjust this value as needed (0-255)
+    // Only what is on screen
+    first = qMax(first, m_renderer.firstBucketOfColumn(m_renderer.firstColumn()));
+    last = qMin(last, m_renderer.lastBucketOfColumn(m_renderer.lastVisibleColumn()));
+    if (first > last)
+    {
+        return;
+    }
 
-    // Calculate intensity with a minimum threshold
-    int intensity = minIntensity;
-    if (m_maxPomodoros > 1)
+    if (!m_backingValid)
     {
-        // Scale the remaining intensity range (minIntensity to 255)
-        int scaledIntensity = (count * (255 - minIntensity)) / m_maxPomodoros;
-        intensity += scaledIntensity;
+        update(); // The next paint rebuilds everything anyway
+        return;
     }
 
-    // Ensure intensity is within bounds
-    intensity = qMin(255, qMax(minIntensity, intensity));
+    QPainter painter(&m_backingImage);
+    painter.setRenderHint(QPainter::Antialiasing);
 
-    // GitHub-like green scale with minimum visibility
-    return QColor(
-        235 - (intensity * 0.8), // Decrease red as count increases
-        235 - (intensity * 0.3) + 20, // Keep green higher
-        235 - (intensity * 0.8) // Decrease blue as count increases
-    );
+    QRect dirty;
+    for (int bucket = first; bucket <= last; bucket++)
+    {
+        QRect rect = m_renderer.cellRect(bucket).adjusted(-1, -1, 1, 1);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.fillRect(rect, Qt::transparent);
+        painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        m_renderer.drawCell(painter, bucket);
+        dirty |= rect;
+    }
+
+    update(dirty);
+}
+
+void PomodoroActivityMap::ensureBackingImage()
+{
+    qreal dpr = devicePixelRatioF();
+    QSize deviceSize = size() * dpr;
+    if (m_backingValid && m_backingImage.size() == deviceSize && qFuzzyCompare(m_backingImage.devicePixelRatio(), dpr))
+    {
+        return;
+    }
+
+    m_backingImage = QImage(deviceSize, QImage::Format_ARGB32_Premultiplied);
+    m_backingImage.setDevicePixelRatio(dpr);
+    m_backingImage.fill(Qt::transparent);
+
+    QPainter painter(&m_backingImage);
+    m_renderer.draw(painter, size(), font(), palette().color(QPalette::WindowText));
+    m_backingValid = true;
+}
+
+void PomodoroActivityMap::invalidateBackingImage()
+{
+    m_backingValid = false;
+    update();
 }
 
-void PomodoroActivityMap::drawLegend(QPainter& painter)
+void PomodoroActivityMap::setHoverIndex(int bucket)
 {
-    int legendX = width() - 240;
-    int legendY = height() - 40;
-    int legendItemWidth = 15;
-    int legendSpacing = 5;
+    if (bucket == m_hoverIndex)
+    {
+        return;
+    }
+
+    // Repaint only the old and new cell, with room for the outline
+    if (m_hoverIndex >= 0)
+    {
+        update(m_renderer.cellRect(m_hoverIndex).adjusted(-1, -1, 1, 1));
+    }
+
+    m_hoverIndex = bucket;
 
-    painter.drawText(legendX, legendY + 12, "Less");
+    if (m_hoverIndex >= 0)
+    {
+        update(m_renderer.cellRect(m_hoverIndex).adjusted(-1, -1, 1, 1));
+    }
+}
 
-    legendX += 40;
+void PomodoroActivityMap::mouseMoveEvent(QMouseEvent* event)
+{
+    int bucket = m_renderer.bucketAt(event->pos());
 
-    // Draw 5 sample boxes representing activity levels
-    for (int i = 0; i < 5; i++)
+    if (bucket >= 0)
     {
-        int value = i * m_maxPomodoros / 4;
-        QColor color = getColorForCount(value);
+        bool changed = bucket != m_hoverIndex;
+        setHoverIndex(bucket);
 
-        QRect rect(legendX + i * (legendItemWidth + legendSpacing),
-                   legendY, legendItemWidth, legendItemWidth);
+        if (changed)
+        {
+            QToolTip::showText(event->globalPos(), m_renderer.toolTipFor(bucket), this, m_renderer.cellRect(bucket));
+        }
+    }
+    else if (!m_legendRect.contains(event->pos()))
+    {
+        setHoverIndex(-1);
+        QToolTip::hideText();
+    }
+
+    QWidget::mouseMoveEvent(event);
+}
+
+void PomodoroActivityMap::leaveEvent(QEvent* event)
+{
+    setHoverIndex(-1);
+    QToolTip::hideText();
 
-        painter.setBrush(color);
-        painter.setPen(QPen(color.darker(110), 1));
-        painter.drawRoundedRect(rect, 2, 2);
+    QWidget::leaveEvent(event);
+}
+
+void PomodoroActivityMap::wheelEvent(QWheelEvent* event)
+{
+    int steps = event->angleDelta().y() / 120;
+    if (steps == 0)
+    {
+        steps = event->angleDelta().x() / 120;
+    }
+
+    if (event->modifiers() & Qt::ControlModifier)
+    {
+        // Ctrl+wheel zooms between daily, weekly and monthly detail
+        int level = qBound(0, static_cast<int>(m_renderer.granularity()) - steps, 2);
+        setGranularity(static_cast<ActivityGranularity>(level));
+    }
+    else
+    {
+        m_scrollBar->setValue(m_scrollBar->value() - steps * 3);
     }
 
-    legendX += 5 * (legendItemWidth + legendSpacing) + 5;
-    painter.drawText(legendX, legendY + 12, "More");
+    event->accept();
 }
 
-PomodoroActivityMap::CellInfo* PomodoroActivityMap::getCellAt(const QPoint& pos)
+void PomodoroActivityMap::resizeEvent(QResizeEvent* event)
 {
-    for (auto& cell : m_cells)
+    QWidget::resizeEvent(event);
+
+    calculateLayout();
+
+    // A different width may call for another level of detail; otherwise it
+    // only shows a different number of columns
+    if (m_autoGranularity)
     {
-        if (cell.rect.contains(pos))
+        ActivityGranularity granularity = ActivityMapRenderer::autoGranularity(
+            m_renderer.startDate(), m_renderer.endDate(), width() - m_renderer.gridLeft() - m_renderer.gridRightMargin());
+        if (granularity != m_renderer.granularity())
         {
-            return &cell;
+            resetColumns(granularity);
+            refreshData();
+            return;
         }
     }
-    return nullptr;
+
+    updateScrollRange();
+    ensureLoaded();
+    invalidateBackingImage();
+}
+
+void PomodoroActivityMap::changeEvent(QEvent* event)
+{
+    // Theme switches arrive as style sheet, palette or font changes
+    if (event->type() == QEvent::PaletteChange || event->type() == QEvent::StyleChange
+        || event->type() == QEvent::FontChange)
+    {
+        invalidateBackingImage();
+    }
+
+    QWidget::changeEvent(event);
+}
+
+void PomodoroActivityMap::calculateLayout()
+{
+    // Scroll bar under the grid, legend anchored to the bottom-right corner
+    int gridLeft = m_renderer.gridLeft();
+    m_scrollBar->setGeometry(gridLeft, m_renderer.gridTop() + m_renderer.gridHeight() + 6,
+                             width() - gridLeft - m_renderer.gridRightMargin(), m_scrollBar->sizeHint().height());
+    m_legendRect = m_renderer.legendRect(size());
 }
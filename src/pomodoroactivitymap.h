@@ -6,17 +6,28 @@
 #define ZIGA_POMODORO_POMODOROACTIVITYMAP_H
 
 #include <QWidget>
-#include <QMap>
+#include <QVector>
+#include <QColor>
 #include <QDate>
-#include <QPair>
 #include <QToolTip>
 #include <QPainter>
 #include <QMouseEvent>
 #include <QLabel>
+#include <QImage>
+
+#include "databasemanager.h" // ActivityGranularity
+#include "activityloader.h"
+#include "activitymaprenderer.h"
 
 // Forward declaration
-class DatabaseManager;
+class QScrollBar;
+class PaintStats;
 
+// Activity heatmap over any date range. Only the columns in view (plus a
+// prefetch margin) are loaded, in chunks on a background thread; cells show
+// as skeletons until their chunk arrives. Long ranges scroll horizontally
+// and switch to weekly or monthly aggregates when daily cells would not fit.
+// Layout and drawing live in ActivityMapRenderer.
 class PomodoroActivityMap : public QWidget
 {
     Q_OBJECT
@@ -28,38 +39,61 @@ public:
     void setDatabaseManager(DatabaseManager* dbManager);
     void setDateRange(const QDate& startDate, const QDate& endDate);
     void refreshData();
+    void setPaintStats(PaintStats* stats); // Null turns profiling off
+
+    // Level of detail; setting it (or Ctrl+wheel) turns off the automatic choice
+    ActivityGranularity getGranularity() const;
+    void setGranularity(ActivityGranularity granularity);
+
+    int getLoadedBucketCount() const; // Buckets currently held in memory
+    bool isLoading() const; // Visible cells or the colour scale not yet loaded
+
+public slots:
+    void onSessionRecorded(const RecordedSession& session); // Updates its cell without a query
 
 protected:
     void paintEvent(QPaintEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
     void leaveEvent(QEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void changeEvent(QEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+
+private slots:
+    void onScrolled(int firstColumn);
+    void onChunkLoaded(quint64 requestId, const QDate& from, const QDate& to, const QList<ActivityBucket>& buckets);
+    void onMaximumLoaded(quint64 requestId, int maximum);
 
 private:
     DatabaseManager* m_dbManager;
-    QDate m_startDate;
-    QDate m_endDate;
-    QMap<QDate, int> m_pomodorosByDate;
-    QMap<QDate, int> m_minutesByDate;
+    PaintStats* m_paintStats;
+    ActivityMapRenderer m_renderer; // Range, loaded data, layout and drawing
+    bool m_autoGranularity;
 
-    QDate m_currentHoverDate;
+    ActivityLoader* m_loader;
+    quint64 m_requestId; // Latest request; results of older ones are ignored
+    bool m_maximumPending; // Colour scale not yet known for this range and level
+
+    QScrollBar* m_scrollBar;
+
+    int m_hoverIndex; // Bucket under the cursor, -1 when none
     QRect m_legendRect;
 
-    int m_cellSize;
-    int m_cellSpacing;
-    int m_maxPomodoros;
-
-    struct CellInfo {
-        QRect rect;
-        QDate date;
-        int count;
-        int minutes;
-    };
-    QList<CellInfo> m_cells;
-
-    void calculateCellPositions();
-    QColor getColorForCount(int count) const;
-    void drawLegend(QPainter& painter);
-    CellInfo* getCellAt(const QPoint& pos);
+    // Labels, cells and legend of the visible columns rendered once at device
+    // resolution; hover paints its outline on top
+    QImage m_backingImage;
+    bool m_backingValid;
+
+    void resetColumns(ActivityGranularity granularity); // Range or level changed
+    void updateScrollRange();
+    void ensureLoaded(bool force = false); // Visible columns plus one page either side
+    void requestPending(int visibleFirstColumn, int visibleLastColumn);
+
+    void calculateLayout();
+    void ensureBackingImage();
+    void invalidateBackingImage();
+    void repaintBuckets(int first, int last); // Into the backing image, then update()
+    void setHoverIndex(int bucket);
 };
 
-#endif // ZIGA_POMODORO_POMODOROACTIVITYMAP_H
\ No newline at end of file
+#endif // ZIGA_POMODORO_POMODOROACTIVITYMAP_H
@@ -0,0 +1,317 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "progressring.h"
+#include "trace.h"
+#include "paintprofiler.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QTimer>
+#include <QtMath>
+
+ProgressRing::ProgressRing(QWidget* parent)
+    : QWidget(parent)
+      , m_progress(0)
+      , m_drawnProgress(0)
+      , m_ringColor(Qt::white)
+      , m_trackColor(255, 255, 255, 40)
+      , m_ringWidth(4)
+      , m_cacheDpr(0)
+      , m_flushTimer(new QTimer(this))
+      , m_repaintInterval(250)
+      , m_effectiveInterval(250)
+      , m_frameBudgetUs(2000)
+      , m_repaintCount(0)
+      , m_lastPaintUs(0)
+      , m_overBudgetCount(0)
+{
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_NoSystemBackground);
+
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setTimerType(Qt::CoarseTimer);
+    connect(m_flushTimer, &QTimer::timeout, this, &ProgressRing::flushProgress);
+}
+
+ProgressRing::~ProgressRing() = default;
+
+void ProgressRing::setProgress(int elapsedSeconds, int totalSeconds)
+{
+    qreal progress = totalSeconds > 0 ? qBound(0.0, qreal(elapsedSeconds) / totalSeconds, 1.0) : 0.0;
+    if (progress == m_progress)
+    {
+        return;
+    }
+    m_progress = progress;
+    scheduleFlush();
+}
+
+qreal ProgressRing::progress() const
+{
+    return m_progress;
+}
+
+void ProgressRing::setRingColor(const QColor& color)
+{
+    if (color == m_ringColor)
+    {
+        return;
+    }
+    m_ringColor = color;
+    m_cacheSize = QSize(); // Redraw the whole arc in the new colour
+    update();
+}
+
+void ProgressRing::setTrackColor(const QColor& color)
+{
+    if (color == m_trackColor)
+    {
+        return;
+    }
+    m_trackColor = color;
+    m_cacheSize = QSize();
+    update();
+}
+
+void ProgressRing::setRingWidth(int width)
+{
+    if (width == m_ringWidth)
+    {
+        return;
+    }
+    m_ringWidth = width;
+    m_cacheSize = QSize();
+    update();
+}
+
+void ProgressRing::setRepaintInterval(int milliseconds)
+{
+    m_repaintInterval = milliseconds;
+    m_effectiveInterval = milliseconds;
+}
+
+void ProgressRing::setFrameBudget(int microseconds)
+{
+    m_frameBudgetUs = microseconds;
+}
+
+int ProgressRing::getRepaintCount() const
+{
+    return m_repaintCount;
+}
+
+qint64 ProgressRing::getLastPaintMicros() const
+{
+    return m_lastPaintUs;
+}
+
+int ProgressRing::getOverBudgetCount() const
+{
+    return m_overBudgetCount;
+}
+
+void ProgressRing::setPaintStats(PaintStats* stats)
+{
+    m_paintStats = stats;
+}
+
+int ProgressRing::getEffectiveRepaintInterval() const
+{
+    return m_effectiveInterval;
+}
+
+void ProgressRing::paintEvent(QPaintEvent* event)
+{
+    ZP_TRACE_SCOPE("paint", "ProgressRing::paintEvent");
+
+    PaintScope profile(m_paintStats, event->region());
+    QElapsedTimer paintTimer;
+    paintTimer.start();
+
+    ensureCaches();
+    if (m_backing.isNull())
+    {
+        return;
+    }
+
+    QPainter painter(this);
+    qreal dpr = m_cacheDpr;
+
+    // Blit only the invalidated parts of both layers
+    for (const QRect& rect : event->region())
+    {
+        QRectF source(rect.x() * dpr, rect.y() * dpr, rect.width() * dpr, rect.height() * dpr);
+        painter.drawPixmap(QRectF(rect), m_track, source);
+        painter.drawImage(QRectF(rect), m_backing, source);
+    }
+
+    m_repaintCount++;
+    m_lastPaintUs = paintTimer.nsecsElapsed() / 1000;
+
+    // Back off while over budget, recover once painting is cheap again
+    if (m_lastPaintUs > m_frameBudgetUs)
+    {
+        m_overBudgetCount++;
+        m_effectiveInterval = qMin(m_effectiveInterval * 2, 4000);
+    }
+    else if (m_effectiveInterval > m_repaintInterval && m_lastPaintUs < m_frameBudgetUs / 2)
+    {
+        m_effectiveInterval = qMax(m_repaintInterval, m_effectiveInterval / 2);
+    }
+}
+
+void ProgressRing::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    m_cacheSize = QSize(); // Caches follow the size
+}
+
+void ProgressRing::flushProgress()
+{
+    m_sinceFlush.start();
+
+    if (ensureCaches())
+    {
+        update(); // The whole ring was just redrawn
+        return;
+    }
+
+    if (m_progress < m_drawnProgress)
+    {
+        // New session: start over
+        m_backing.fill(Qt::transparent);
+        m_drawnProgress = 0;
+        drawSegment(0, m_progress);
+        m_drawnProgress = m_progress;
+        update(ringRect().adjusted(-m_ringWidth, -m_ringWidth, m_ringWidth, m_ringWidth).toAlignedRect());
+        return;
+    }
+
+    if (m_progress > m_drawnProgress)
+    {
+        QRect dirty = segmentBounds(m_drawnProgress, m_progress);
+        drawSegment(m_drawnProgress, m_progress);
+        m_drawnProgress = m_progress;
+        update(dirty);
+    }
+}
+
+QRectF ProgressRing::ringRect() const
+{
+    qreal side = qMin(width(), height()) - m_ringWidth - 2;
+    return QRectF((width() - side) / 2.0, (height() - side) / 2.0, side, side);
+}
+
+QRegion ProgressRing::shapeRegion() const
+{
+    int pad = m_ringWidth / 2 + 1;
+    QRect ring = ringRect().toAlignedRect();
+    return QRegion(ring.adjusted(-pad, -pad, pad, pad), QRegion::Ellipse)
+        - QRegion(ring.adjusted(pad, pad, -pad, -pad), QRegion::Ellipse);
+}
+
+bool ProgressRing::ensureCaches()
+{
+    qreal dpr = devicePixelRatioF();
+    if (size().isEmpty() || (m_cacheSize == size() && qFuzzyCompare(dpr, m_cacheDpr)))
+    {
+        return false;
+    }
+    m_cacheSize = size();
+    m_cacheDpr = dpr;
+
+    QSize deviceSize = size() * dpr;
+    QPen pen(m_trackColor, m_ringWidth);
+
+    // Track
+    QPixmap track(deviceSize);
+    track.setDevicePixelRatio(dpr);
+    track.fill(Qt::transparent);
+    {
+        QPainter painter(&track);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(pen);
+        painter.drawEllipse(ringRect());
+    }
+    m_track = track;
+
+    // Progress so far
+    m_backing = QImage(deviceSize, QImage::Format_ARGB32_Premultiplied);
+    m_backing.setDevicePixelRatio(dpr);
+    m_backing.fill(Qt::transparent);
+    drawSegment(0, m_progress);
+    m_drawnProgress = m_progress;
+    return true;
+}
+
+void ProgressRing::drawSegment(qreal from, qreal to)
+{
+    if (to <= from || m_backing.isNull())
+    {
+        return;
+    }
+
+    // Overlap the previous segment slightly so antialiased joins stay seamless
+    qreal start = qMax(0.0, from - 0.002);
+
+    QPainter painter(&m_backing);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(m_ringColor, m_ringWidth, Qt::SolidLine, Qt::FlatCap));
+
+    // Clockwise from twelve o'clock; Qt angles are counter-clockwise in 1/16 degrees
+    int startAngle = qRound((90.0 - start * 360.0) * 16);
+    int spanAngle = -qRound((to - start) * 360.0 * 16);
+    painter.drawArc(ringRect(), startAngle, spanAngle);
+}
+
+QRect ProgressRing::segmentBounds(qreal from, qreal to) const
+{
+    QRectF ring = ringRect();
+    QPointF center = ring.center();
+    qreal radius = ring.width() / 2.0;
+
+    auto pointAt = [&](qreal fraction)
+    {
+        qreal angle = qDegreesToRadians(90.0 - fraction * 360.0);
+        return QPointF(center.x() + radius * qCos(angle), center.y() - radius * qSin(angle));
+    };
+
+    QPointF first = pointAt(qMax(0.0, from - 0.002));
+    QRectF bounds(first, first);
+    auto include = [&bounds](const QPointF& point)
+    {
+        bounds.setLeft(qMin(bounds.left(), point.x()));
+        bounds.setRight(qMax(bounds.right(), point.x()));
+        bounds.setTop(qMin(bounds.top(), point.y()));
+        bounds.setBottom(qMax(bounds.bottom(), point.y()));
+    };
+    include(pointAt(to));
+
+    // Extremes of the circle that the segment passes (every quarter turn)
+    for (int quarter = qFloor(from * 4) + 1; quarter <= qFloor(to * 4) && quarter <= 4; quarter++)
+    {
+        include(pointAt(quarter / 4.0));
+    }
+
+    qreal pad = m_ringWidth / 2.0 + 2;
+    return bounds.adjusted(-pad, -pad, pad, pad).toAlignedRect();
+}
+
+void ProgressRing::scheduleFlush()
+{
+    if (m_flushTimer->isActive())
+    {
+        return; // Coalesced into the pending flush
+    }
+
+    qint64 sinceLast = m_sinceFlush.isValid() ? m_sinceFlush.elapsed() : m_effectiveInterval;
+    if (sinceLast >= m_effectiveInterval)
+    {
+        flushProgress();
+    }
+    else
+    {
+        m_flushTimer->start(int(m_effectiveInterval - sinceLast));
+    }
+}
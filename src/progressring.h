@@ -0,0 +1,90 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_PROGRESSRING_H
+#define ZIGA_POMODORO_PROGRESSRING_H
+
+#include <QWidget>
+#include <QPixmap>
+#include <QImage>
+#include <QRegion>
+#include <QElapsedTimer>
+
+class QTimer;
+class PaintStats;
+
+// Circular session progress drawn behind the countdown. The faint track is a
+// cached pixmap per size and device pixel ratio; progress is accumulated in
+// a persistent backing image where each update only draws the new arc
+// segment. Repaints are limited to the segment's bounding box and coalesced
+// to a few per second. If painting exceeds the frame budget the repaint
+// interval backs off.
+class ProgressRing : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ProgressRing(QWidget* parent = nullptr);
+    ~ProgressRing() override;
+
+    void setProgress(int elapsedSeconds, int totalSeconds);
+    qreal progress() const;
+
+    void setRingColor(const QColor& color);
+    void setTrackColor(const QColor& color);
+    void setRingWidth(int width);
+
+    // Area the ring's stroke covers, in widget coordinates
+    QRegion shapeRegion() const;
+
+    void setRepaintInterval(int milliseconds); // Default 250 ms
+    void setFrameBudget(int microseconds); // Default 2 ms
+
+    // Paint statistics
+    int getRepaintCount() const;
+    qint64 getLastPaintMicros() const;
+    int getOverBudgetCount() const;
+    int getEffectiveRepaintInterval() const;
+    void setPaintStats(PaintStats* stats); // Null turns profiling off
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private slots:
+    void flushProgress();
+
+private:
+    QRectF ringRect() const;
+    bool ensureCaches(); // True if the caches were rebuilt
+    void drawSegment(qreal from, qreal to);
+    QRect segmentBounds(qreal from, qreal to) const;
+    void scheduleFlush();
+
+    qreal m_progress; // Target, 0..1
+    qreal m_drawnProgress; // Already in the backing image
+    QColor m_ringColor;
+    QColor m_trackColor;
+    int m_ringWidth;
+
+    // Caches
+    QPixmap m_track;
+    QImage m_backing;
+    QSize m_cacheSize;
+    qreal m_cacheDpr;
+
+    // Repaint pacing
+    QTimer* m_flushTimer;
+    QElapsedTimer m_sinceFlush;
+    int m_repaintInterval;
+    int m_effectiveInterval;
+    int m_frameBudgetUs;
+
+    int m_repaintCount;
+    qint64 m_lastPaintUs;
+    int m_overBudgetCount;
+    PaintStats* m_paintStats = nullptr;
+};
+
+#endif // ZIGA_POMODORO_PROGRESSRING_H
@@ -0,0 +1,82 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "sessioncontroller.h"
+#include "settings.h"
+#include "databasemanager.h"
+
+SessionController::SessionController(Settings* settings, QObject* parent)
+    : QObject(parent)
+      , m_settings(settings)
+      , m_timer(new ThreadedTimer(this))
+      , m_dbManager(nullptr)
+{
+    connect(m_timer, &ThreadedTimer::timerTick, this, &SessionController::timerTick);
+    connect(m_timer, &ThreadedTimer::modeChanged, this, &SessionController::modeChanged);
+    connect(m_timer, &ThreadedTimer::stateChanged, this, &SessionController::stateChanged);
+    connect(m_timer, &ThreadedTimer::timerCompleted, this, &SessionController::sessionCompleted);
+    connect(m_timer, &ThreadedTimer::pomodorosCompletedChanged, this, &SessionController::pomodorosCompletedChanged);
+    connect(m_timer, &ThreadedTimer::sessionRecorded, this, &SessionController::sessionRecorded);
+
+    connect(m_settings, &Settings::settingsChanged, this, &SessionController::applySettings);
+    applySettings();
+}
+
+SessionController::~SessionController() = default;
+
+ThreadedTimer* SessionController::getTimer() const
+{
+    return m_timer;
+}
+
+void SessionController::setDatabaseManager(DatabaseManager* dbManager)
+{
+    m_dbManager = dbManager;
+    m_timer->setDatabaseManager(dbManager);
+}
+
+DatabaseManager* SessionController::getDatabaseManager() const
+{
+    return m_dbManager;
+}
+
+bool SessionController::restoreSession()
+{
+    return m_timer->restoreSnapshot();
+}
+
+void SessionController::startPause()
+{
+    if (m_timer->getState() == Timer::TimerState::Running)
+    {
+        m_timer->pause();
+    }
+    else
+    {
+        m_timer->start();
+    }
+}
+
+void SessionController::stop()
+{
+    m_timer->stopSession();
+}
+
+void SessionController::skipBreak()
+{
+    // Skip current break and move to next work session
+    if (m_timer->getMode() == Timer::TimerMode::ShortBreak ||
+        m_timer->getMode() == Timer::TimerMode::LongBreak)
+    {
+        m_timer->skipBreak();
+    }
+}
+
+void SessionController::applySettings()
+{
+    m_timer->setWorkDuration(m_settings->getWorkDuration());
+    m_timer->setShortBreakDuration(m_settings->getShortBreakDuration());
+    m_timer->setLongBreakDuration(m_settings->getLongBreakDuration());
+    m_timer->setSchedule(m_settings->getSessionSchedule());
+}
@@ -0,0 +1,56 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_SESSIONCONTROLLER_H
+#define ZIGA_POMODORO_SESSIONCONTROLLER_H
+
+#include <QObject>
+
+#include "threadedtimer.h"
+
+class Settings;
+class DatabaseManager;
+
+// Owns the single timer engine of the application and fans its events out
+// to the windows, persistence and notifiers. Timer settings are applied here
+// rather than by each window.
+class SessionController : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionController(Settings* settings, QObject* parent = nullptr);
+    ~SessionController() override;
+
+    ThreadedTimer* getTimer() const;
+
+    void setDatabaseManager(DatabaseManager* dbManager);
+    DatabaseManager* getDatabaseManager() const;
+
+    // Resumes the previous run; call before any window is shown
+    bool restoreSession();
+
+    // Commands
+    void startPause();
+    void stop(); // Records an interrupted work session and resets
+    void skipBreak();
+
+signals:
+    void timerTick(int remainingSeconds);
+    void modeChanged(Timer::TimerMode newMode);
+    void stateChanged(Timer::TimerState newState);
+    void sessionCompleted(Timer::TimerMode completedMode); // Emitted after the session is recorded
+    void pomodorosCompletedChanged(int count);
+    void sessionRecorded(const RecordedSession& session); // Feeds the statistics views
+
+private slots:
+    void applySettings();
+
+private:
+    Settings* m_settings;
+    ThreadedTimer* m_timer;
+    DatabaseManager* m_dbManager;
+};
+
+#endif // ZIGA_POMODORO_SESSIONCONTROLLER_H
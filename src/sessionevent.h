@@ -0,0 +1,32 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_SESSIONEVENT_H
+#define ZIGA_POMODORO_SESSIONEVENT_H
+
+#include <QtGlobal>
+
+#include "sessionschedule.h"
+
+// One entry of the append-only session event log
+struct SessionEvent
+{
+    enum class Type : quint8
+    {
+        Start,
+        Pause,
+        Resume,
+        Skip,
+        Reset,
+        Complete
+    };
+
+    qint64 epochMs = 0; // Wall-clock time of the event
+    Type type = Type::Start;
+    SessionMode mode = SessionMode::Work; // Mode of the session the event belongs to
+};
+
+Q_DECLARE_TYPEINFO(SessionEvent, Q_PRIMITIVE_TYPE);
+
+#endif // ZIGA_POMODORO_SESSIONEVENT_H
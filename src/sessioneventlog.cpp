@@ -0,0 +1,79 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "sessioneventlog.h"
+#include "databasemanager.h"
+#include <QTimer>
+
+SessionEventLog::SessionEventLog(QObject* parent)
+    : QObject(parent)
+      , m_dbManager(nullptr)
+      , m_flushTimer(new QTimer(this))
+{
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setTimerType(Qt::VeryCoarseTimer);
+    m_flushTimer->setInterval(30 * 1000);
+    connect(m_flushTimer, &QTimer::timeout, this, &SessionEventLog::flush);
+}
+
+SessionEventLog::~SessionEventLog()
+{
+    flush();
+}
+
+void SessionEventLog::setDatabaseManager(DatabaseManager* dbManager)
+{
+    m_dbManager = dbManager;
+}
+
+void SessionEventLog::setFlushInterval(int milliseconds)
+{
+    m_flushTimer->setInterval(milliseconds);
+}
+
+void SessionEventLog::append(const SessionEvent& event)
+{
+    m_pending.append(event);
+
+    // The first buffered event arms the flush; later ones ride along
+    if (!m_flushTimer->isActive())
+    {
+        m_flushTimer->start();
+    }
+}
+
+int SessionEventLog::pendingCount() const
+{
+    return m_pending.size();
+}
+
+bool SessionEventLog::flush()
+{
+    m_flushTimer->stop();
+
+    if (m_pending.isEmpty())
+    {
+        return true;
+    }
+
+    if (!m_dbManager || !m_dbManager->isInitialized())
+    {
+        // Keep memory bounded when there is nowhere to write
+        m_pending.clear();
+        return false;
+    }
+
+    if (!m_dbManager->appendSessionEvents(m_pending))
+    {
+        // Retried on the next flush, unless the backlog has grown unreasonably
+        if (m_pending.size() > 4096)
+        {
+            m_pending.clear();
+        }
+        return false;
+    }
+
+    m_pending.clear();
+    return true;
+}
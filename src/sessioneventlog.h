@@ -0,0 +1,41 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_SESSIONEVENTLOG_H
+#define ZIGA_POMODORO_SESSIONEVENTLOG_H
+
+#include <QObject>
+#include <QVector>
+
+#include "sessionevent.h"
+
+class QTimer;
+class DatabaseManager;
+
+// Buffers session events and writes them in one transaction, either when a
+// session ends or after the flush interval. Nothing is written per tick.
+class SessionEventLog : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionEventLog(QObject* parent = nullptr);
+    ~SessionEventLog() override;
+
+    void setDatabaseManager(DatabaseManager* dbManager);
+    void setFlushInterval(int milliseconds); // Default 30 s
+
+    void append(const SessionEvent& event);
+    int pendingCount() const;
+
+public slots:
+    bool flush();
+
+private:
+    DatabaseManager* m_dbManager;
+    QTimer* m_flushTimer;
+    QVector<SessionEvent> m_pending;
+};
+
+#endif // ZIGA_POMODORO_SESSIONEVENTLOG_H
@@ -0,0 +1,87 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "sessionnotifier.h"
+#include "trace.h"
+#include "sessioncontroller.h"
+#include "settings.h"
+#include <QUrl>
+
+SessionNotifier::SessionNotifier(SessionController* controller, Settings* settings, QSystemTrayIcon* trayIcon,
+                                 QObject* parent)
+    : QObject(parent)
+      , m_settings(settings)
+      , m_trayIcon(trayIcon)
+#ifdef HAVE_QT_MULTIMEDIA
+      , m_mediaPlayer(new QMediaPlayer(this))
+#endif
+{
+    connect(controller, &SessionController::sessionCompleted, this, &SessionNotifier::handleSessionCompleted);
+}
+
+SessionNotifier::~SessionNotifier() = default;
+
+void SessionNotifier::handleSessionCompleted(Timer::TimerMode completedMode)
+{
+    ZP_TRACE_SCOPE("notify", "SessionNotifier::handleSessionCompleted");
+
+    QString title;
+    QString message;
+
+    if (completedMode == Timer::TimerMode::Work)
+    {
+        title = "Work Session Complete!";
+        message = "Time for a break.";
+    }
+    else if (completedMode == Timer::TimerMode::ShortBreak || completedMode == Timer::TimerMode::LongBreak)
+    {
+        title = "Break Over!";
+        message = "Time to get back to work.";
+    }
+
+    // Show notification - using existing setting name
+    if (m_settings->getDesktopNotificationsEnabled())
+    {
+        showDesktopNotification(title, message);
+    }
+
+    // Play sound - using existing setting name
+    if (m_settings->getSoundEnabled())
+    {
+        playNotificationSound();
+    }
+}
+
+void SessionNotifier::playNotificationSound()
+{
+    ZP_TRACE_SCOPE("sound", "SessionNotifier::playNotificationSound");
+
+#ifdef HAVE_QT_MULTIMEDIA
+    QString soundFile = m_settings->getSoundFile();
+
+    // Check if it's a QRC path (starts with ":/")
+    QUrl mediaUrl;
+    if (soundFile.startsWith(":/"))
+    {
+        mediaUrl = QUrl("qrc" + soundFile); // Convert ":/" to "qrc:/"
+    }
+    else
+    {
+        mediaUrl = QUrl::fromLocalFile(soundFile); // Assume it's a filesystem path
+    }
+
+    m_mediaPlayer->setMedia(mediaUrl);
+    m_mediaPlayer->play();
+#endif
+}
+
+void SessionNotifier::showDesktopNotification(const QString& title, const QString& message)
+{
+    ZP_TRACE_SCOPE("notify", "SessionNotifier::showDesktopNotification");
+
+    if (m_trayIcon)
+    {
+        m_trayIcon->showMessage(title, message, QSystemTrayIcon::Information, 3000);
+    }
+}
@@ -0,0 +1,44 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_SESSIONNOTIFIER_H
+#define ZIGA_POMODORO_SESSIONNOTIFIER_H
+
+#include <QObject>
+#include <QSystemTrayIcon>
+
+#ifdef HAVE_QT_MULTIMEDIA
+#include <QMediaPlayer>
+#endif
+
+#include "timer.h"
+
+class Settings;
+class SessionController;
+
+// Desktop notification and sound when a session completes
+class SessionNotifier : public QObject
+{
+    Q_OBJECT
+
+public:
+    SessionNotifier(SessionController* controller, Settings* settings, QSystemTrayIcon* trayIcon,
+                    QObject* parent = nullptr);
+    ~SessionNotifier() override;
+
+private slots:
+    void handleSessionCompleted(Timer::TimerMode completedMode);
+
+private:
+    void playNotificationSound();
+    void showDesktopNotification(const QString& title, const QString& message);
+
+    Settings* m_settings;
+    QSystemTrayIcon* m_trayIcon;
+#ifdef HAVE_QT_MULTIMEDIA
+    QMediaPlayer* m_mediaPlayer;
+#endif
+};
+
+#endif // ZIGA_POMODORO_SESSIONNOTIFIER_H
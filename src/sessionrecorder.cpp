@@ -0,0 +1,242 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "sessionrecorder.h"
+#include "trace.h"
+#include "sessioneventlog.h"
+#include "databasemanager.h"
+
+SessionRecorder::SessionRecorder(Timer* timer, QObject* parent)
+    : QObject(parent)
+      , m_timer(timer)
+      , m_dbManager(nullptr)
+      , m_eventLog(new SessionEventLog(this))
+      , m_restoring(false)
+      , m_restoredPausedMs(0)
+      , m_restoredInterruptions(0)
+{
+    connect(m_timer, &Timer::stateChanged, this, &SessionRecorder::handleStateChanged);
+    connect(m_timer, &Timer::timerCompleted, this, &SessionRecorder::handleTimerCompleted);
+    connect(m_timer, &Timer::sessionSkipped, this, &SessionRecorder::handleSessionSkipped);
+}
+
+SessionRecorder::~SessionRecorder() = default;
+
+void SessionRecorder::setDatabaseManager(DatabaseManager* dbManager)
+{
+    m_dbManager = dbManager;
+    m_eventLog->setDatabaseManager(dbManager);
+}
+
+void SessionRecorder::recordInterrupted()
+{
+    ZP_TRACE_SCOPE("session", "SessionRecorder::recordInterrupted");
+
+    if (!canRecord() || !m_tally.isOpen() ||
+        m_timer->getState() == Timer::TimerState::Stopped)
+    {
+        return;
+    }
+
+    if (m_tally.mode() == Timer::TimerMode::Work)
+    {
+        // The Reset event and mark are logged when the timer actually stops
+        qint64 nowMs = nowEpochMs();
+        SessionTimeline timeline = m_timeline;
+        timeline.append(SessionEvent::Type::Reset, sessionOffsetSeconds());
+
+        m_dbManager->recordPomodoroSession(m_sessionStartTime, roundToSeconds(m_tally.activeMs(nowMs)),
+                                           false, // incomplete
+                                           roundToSeconds(m_tally.pausedMs(nowMs)), m_tally.interruptions(),
+                                           timeline.encoded());
+    }
+}
+
+QDateTime SessionRecorder::sessionStartTime() const
+{
+    return m_tally.isOpen() ? m_sessionStartTime : QDateTime();
+}
+
+qint64 SessionRecorder::pausedMs() const
+{
+    return m_tally.isOpen() ? m_tally.pausedMs(nowEpochMs()) : 0;
+}
+
+int SessionRecorder::interruptionCount() const
+{
+    return m_tally.isOpen() ? m_tally.interruptions() : 0;
+}
+
+qint64 SessionRecorder::activeMs() const
+{
+    return m_tally.isOpen() ? m_tally.activeMs(nowEpochMs()) : 0;
+}
+
+QByteArray SessionRecorder::timeline() const
+{
+    return m_tally.isOpen() ? m_timeline.encoded() : QByteArray();
+}
+
+void SessionRecorder::restoreSession(const QDateTime& startTime, qint64 pausedMs, int interruptions,
+                                     const QByteArray& timeline)
+{
+    m_sessionStartTime = startTime;
+    m_restoredPausedMs = pausedMs;
+    m_restoredInterruptions = interruptions;
+    m_timeline = SessionTimeline::fromEncoded(timeline); // Empty if malformed
+    m_restoring = true;
+}
+
+void SessionRecorder::handleStateChanged(Timer::TimerState state)
+{
+    if (m_restoring)
+    {
+        // Active time is whatever the restored timer has already used up,
+        // including time that ran out while the application was closed
+        m_restoring = false;
+        m_tally = SessionTally();
+        if (state != Timer::TimerState::Stopped)
+        {
+            m_tally.restore(m_sessionStartTime.toMSecsSinceEpoch(), m_timer->getMode(),
+                            m_timer->getElapsedTime() * 1000LL, m_restoredPausedMs, m_restoredInterruptions,
+                            state == Timer::TimerState::Running, nowEpochMs());
+        }
+        return;
+    }
+
+    switch (state)
+    {
+    case Timer::TimerState::Running:
+        if (!m_tally.isOpen())
+        {
+            openSession();
+        }
+        else if (!m_tally.isRunning())
+        {
+            logEvent(SessionEvent::Type::Resume, nowEpochMs());
+        }
+        break;
+
+    case Timer::TimerState::Paused:
+        if (m_tally.isRunning())
+        {
+            logEvent(SessionEvent::Type::Pause, nowEpochMs());
+        }
+        break;
+
+    case Timer::TimerState::Stopped:
+        if (m_tally.isOpen())
+        {
+            closeSession(SessionEvent::Type::Reset);
+        }
+        break;
+    }
+}
+
+void SessionRecorder::handleTimerCompleted(Timer::TimerMode completedMode)
+{
+    ZP_TRACE_SCOPE("session", "SessionRecorder::handleTimerCompleted");
+
+    if (!m_tally.isOpen())
+    {
+        return;
+    }
+
+    // The Complete event closes the tally; the row gets its final totals
+    m_timeline.append(SessionEvent::Type::Complete, sessionOffsetSeconds());
+    closeSession(SessionEvent::Type::Complete);
+
+    if (canRecord())
+    {
+        int duration = roundToSeconds(m_tally.activeMs(0));
+        int paused = roundToSeconds(m_tally.pausedMs(0));
+        int interruptions = m_tally.interruptions();
+        QByteArray timeline = m_timeline.encoded();
+
+        if (completedMode == Timer::TimerMode::Work)
+        {
+            m_dbManager->recordPomodoroSession(m_sessionStartTime, duration, true, paused, interruptions, timeline);
+        }
+        else if (completedMode == Timer::TimerMode::ShortBreak)
+        {
+            m_dbManager->recordBreakSession(m_sessionStartTime, duration, false, paused, interruptions, timeline);
+        }
+        else if (completedMode == Timer::TimerMode::LongBreak)
+        {
+            m_dbManager->recordBreakSession(m_sessionStartTime, duration, true, paused, interruptions, timeline);
+        }
+    }
+}
+
+void SessionRecorder::handleSessionSkipped(Timer::TimerMode skippedMode)
+{
+    Q_UNUSED(skippedMode);
+
+    if (m_tally.isOpen())
+    {
+        closeSession(SessionEvent::Type::Skip);
+    }
+
+    // Skipping a running break starts the next session straight away
+    if (m_timer->getState() == Timer::TimerState::Running)
+    {
+        openSession();
+    }
+}
+
+bool SessionRecorder::canRecord() const
+{
+    return m_dbManager != nullptr && m_dbManager->isInitialized();
+}
+
+void SessionRecorder::openSession()
+{
+    m_sessionStartTime = m_timer->getClock()->currentDateTime();
+    m_timeline.clear();
+    logEvent(SessionEvent::Type::Start, m_sessionStartTime.toMSecsSinceEpoch());
+}
+
+void SessionRecorder::closeSession(SessionEvent::Type type)
+{
+    logEvent(type, nowEpochMs());
+
+    // Session boundaries are the natural batch points
+    m_eventLog->flush();
+}
+
+void SessionRecorder::logEvent(SessionEvent::Type type, qint64 epochMs)
+{
+    SessionEvent event;
+    event.epochMs = epochMs;
+    event.type = type;
+    event.mode = type == SessionEvent::Type::Start ? m_timer->getMode() : m_tally.mode();
+
+    // The totals and the log see the very same event
+    m_tally.apply(event);
+    m_eventLog->append(event);
+
+    // Pauses, resumes and skips also go into the compact per-session timeline;
+    // Complete is added before the row is written
+    if (type == SessionEvent::Type::Pause || type == SessionEvent::Type::Resume ||
+        type == SessionEvent::Type::Skip || type == SessionEvent::Type::Reset)
+    {
+        m_timeline.append(type, sessionOffsetSeconds());
+    }
+}
+
+qint64 SessionRecorder::nowEpochMs() const
+{
+    return m_timer->getClock()->currentDateTime().toMSecsSinceEpoch();
+}
+
+qint32 SessionRecorder::sessionOffsetSeconds() const
+{
+    // Wall-clock based so offsets stay meaningful across a restart
+    return static_cast<qint32>(m_sessionStartTime.msecsTo(m_timer->getClock()->currentDateTime()) / 1000);
+}
+
+int SessionRecorder::roundToSeconds(qint64 ms)
+{
+    return static_cast<int>((ms + 500) / 1000);
+}
@@ -0,0 +1,76 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_SESSIONRECORDER_H
+#define ZIGA_POMODORO_SESSIONRECORDER_H
+
+#include <QObject>
+#include <QDateTime>
+
+#include "timer.h"
+#include "clock.h"
+#include "sessionevent.h"
+#include "sessiontally.h"
+#include "sessiontimeline.h"
+
+class DatabaseManager;
+class SessionEventLog;
+
+// Persists finished and interrupted sessions of a Timer. Every transition is
+// appended to the session event log, and active time, paused time and the
+// number of interruptions are folded from those same events by a
+// SessionTally, so paused time is never counted as work and replaying the
+// log gives the recorded totals. Times come from the timer's clock, so
+// simulated runs record simulated dates.
+class SessionRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SessionRecorder(Timer* timer, QObject* parent = nullptr);
+    ~SessionRecorder() override;
+
+    void setDatabaseManager(DatabaseManager* dbManager);
+
+    // Records the current work session as interrupted (e.g. the Stop button)
+    void recordInterrupted();
+
+    // Session in progress, carried across restarts by SessionSnapshotStore
+    QDateTime sessionStartTime() const;
+    qint64 pausedMs() const;
+    int interruptionCount() const;
+    QByteArray timeline() const; // Encoded SessionTimeline of the session so far
+    void restoreSession(const QDateTime& startTime, qint64 pausedMs, int interruptions,
+                        const QByteArray& timeline = QByteArray());
+
+    // Totals of the session in progress
+    qint64 activeMs() const;
+
+private slots:
+    void handleStateChanged(Timer::TimerState state);
+    void handleTimerCompleted(Timer::TimerMode completedMode);
+    void handleSessionSkipped(Timer::TimerMode skippedMode);
+
+private:
+    bool canRecord() const;
+    void openSession();
+    void closeSession(SessionEvent::Type type);
+    void logEvent(SessionEvent::Type type, qint64 epochMs);
+    qint64 nowEpochMs() const;
+    qint32 sessionOffsetSeconds() const;
+    static int roundToSeconds(qint64 ms);
+
+    Timer* m_timer;
+    DatabaseManager* m_dbManager;
+    SessionEventLog* m_eventLog;
+
+    QDateTime m_sessionStartTime; // Track when the current session started
+    SessionTally m_tally; // Open session, mode and totals, from the logged events
+    bool m_restoring; // The next state change comes from Timer::restore()
+    qint64 m_restoredPausedMs; // Carried until the restored timer reports its state
+    int m_restoredInterruptions;
+    SessionTimeline m_timeline; // Stored with the session row
+};
+
+#endif // ZIGA_POMODORO_SESSIONRECORDER_H
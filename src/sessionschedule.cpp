@@ -0,0 +1,190 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "sessionschedule.h"
+#include <QRegularExpression>
+
+SessionSchedule::SessionSchedule()
+    : m_steps{}
+      , m_size(0)
+{
+    fillClassic(4);
+}
+
+SessionSchedule SessionSchedule::classic(int longBreakInterval)
+{
+    SessionSchedule schedule;
+    schedule.fillClassic(longBreakInterval);
+    return schedule;
+}
+
+void SessionSchedule::fillClassic(int longBreakInterval)
+{
+    int interval = qBound(1, longBreakInterval, MaxSteps / 2);
+    m_size = interval * 2;
+
+    for (int i = 0; i < m_size; i += 2)
+    {
+        bool lastPomodoro = (i + 2 == m_size);
+        m_steps[i] = {SessionMode::Work, static_cast<quint8>(i + 1), 0};
+        m_steps[i + 1] = {
+            lastPomodoro ? SessionMode::LongBreak : SessionMode::ShortBreak,
+            static_cast<quint8>(lastPomodoro ? 0 : i + 2),
+            0
+        };
+    }
+}
+
+SessionSchedule SessionSchedule::builtIn(const QString& name, int longBreakInterval)
+{
+    if (name == "52-17")
+    {
+        return fromTable(SchedulePlans::FiftyTwoSeventeen);
+    }
+    if (name == "ultradian")
+    {
+        return fromTable(SchedulePlans::Ultradian);
+    }
+    if (name == "warmup")
+    {
+        return fromTable(SchedulePlans::WarmUp);
+    }
+
+    return classic(longBreakInterval);
+}
+
+QStringList SessionSchedule::builtInNames()
+{
+    return {"classic", "52-17", "ultradian", "warmup"};
+}
+
+SessionSchedule SessionSchedule::parse(const QString& spec, bool* ok, QString* error)
+{
+    static const QRegularExpression stepPattern("^([wslWSL])(\\d{0,3})$");
+
+    SessionSchedule schedule;
+    schedule.m_size = 0;
+
+    int loopStart = 0;
+    bool hasWork = false;
+    QString message;
+
+    const QStringList tokens = QString(spec).replace('|', " | ").split(QRegularExpression("[\\s,]+"));
+    for (const QString& token : tokens)
+    {
+        if (token.isEmpty())
+        {
+            continue;
+        }
+
+        if (token == "|")
+        {
+            loopStart = schedule.m_size;
+            continue;
+        }
+
+        QRegularExpressionMatch match = stepPattern.match(token);
+        if (!match.hasMatch())
+        {
+            message = QString("Unknown step \"%1\": use w, s or l, optionally followed by minutes").arg(token);
+            break;
+        }
+        if (schedule.m_size == MaxSteps)
+        {
+            message = QString("A plan can have at most %1 steps").arg(MaxSteps);
+            break;
+        }
+
+        ScheduleStep step;
+        switch (match.captured(1).toLower().at(0).toLatin1())
+        {
+        case 'w':
+            step.mode = SessionMode::Work;
+            hasWork = true;
+            break;
+        case 's':
+            step.mode = SessionMode::ShortBreak;
+            break;
+        default:
+            step.mode = SessionMode::LongBreak;
+            break;
+        }
+        step.minutes = static_cast<quint16>(match.captured(2).toUInt());
+        step.next = static_cast<quint8>(schedule.m_size + 1);
+
+        schedule.m_steps[schedule.m_size++] = step;
+    }
+
+    if (message.isEmpty() && !hasWork)
+    {
+        message = "The plan needs at least one work step";
+    }
+    else if (message.isEmpty() && loopStart >= schedule.m_size)
+    {
+        message = "Nothing after '|' to repeat";
+    }
+
+    if (!message.isEmpty())
+    {
+        if (ok)
+        {
+            *ok = false;
+        }
+        if (error)
+        {
+            *error = message;
+        }
+        return SessionSchedule();
+    }
+
+    // Close the loop
+    schedule.m_steps[schedule.m_size - 1].next = static_cast<quint8>(loopStart);
+
+    if (ok)
+    {
+        *ok = true;
+    }
+    return schedule;
+}
+
+int SessionSchedule::nextWorkStep(int index) const
+{
+    int candidate = next(index);
+    for (int i = 0; i < m_size && m_steps[candidate].mode != SessionMode::Work; i++)
+    {
+        candidate = next(candidate);
+    }
+    return candidate;
+}
+
+int SessionSchedule::firstStepWithMode(SessionMode mode) const
+{
+    for (int i = 0; i < m_size; i++)
+    {
+        if (m_steps[i].mode == mode)
+        {
+            return i;
+        }
+    }
+    return 0;
+}
+
+bool SessionSchedule::operator==(const SessionSchedule& other) const
+{
+    if (m_size != other.m_size)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < m_size; i++)
+    {
+        const ScheduleStep& a = m_steps[i];
+        const ScheduleStep& b = other.m_steps[i];
+        if (a.mode != b.mode || a.next != b.next || a.minutes != b.minutes)
+        {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,109 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_SESSIONSCHEDULE_H
+#define ZIGA_POMODORO_SESSIONSCHEDULE_H
+
+#include <QString>
+#include <QStringList>
+#include <array>
+
+enum class SessionMode : quint8
+{
+    Work,
+    ShortBreak,
+    LongBreak
+};
+
+// One row of a schedule transition table
+struct ScheduleStep
+{
+    SessionMode mode;
+    quint8 next; // Index of the step that follows this one
+    quint16 minutes; // 0 = use the configured duration for the mode
+};
+
+// Built-in plans as compile-time transition tables. Steps with a duration of
+// 0 follow the work/break durations configured in the settings.
+namespace SchedulePlans
+{
+    constexpr std::array<ScheduleStep, 2> FiftyTwoSeventeen{{
+        {SessionMode::Work, 1, 52},
+        {SessionMode::ShortBreak, 0, 17},
+    }};
+
+    constexpr std::array<ScheduleStep, 2> Ultradian{{
+        {SessionMode::Work, 1, 90},
+        {SessionMode::LongBreak, 0, 20},
+    }};
+
+    // A short warm-up round, then the classic four pomodoro cycle
+    constexpr std::array<ScheduleStep, 10> WarmUp{{
+        {SessionMode::Work, 1, 10},
+        {SessionMode::ShortBreak, 2, 3},
+        {SessionMode::Work, 3, 0},
+        {SessionMode::ShortBreak, 4, 0},
+        {SessionMode::Work, 5, 0},
+        {SessionMode::ShortBreak, 6, 0},
+        {SessionMode::Work, 7, 0},
+        {SessionMode::ShortBreak, 8, 0},
+        {SessionMode::Work, 9, 0},
+        {SessionMode::LongBreak, 2, 0},
+    }};
+}
+
+class SessionSchedule
+{
+public:
+    static constexpr int MaxSteps = 32;
+
+    // Defaults to the classic plan with a long break every 4 pomodoros
+    SessionSchedule();
+
+    template <std::size_t N>
+    static SessionSchedule fromTable(const std::array<ScheduleStep, N>& table)
+    {
+        static_assert(N > 0 && N <= MaxSteps, "Schedule table size out of range");
+
+        SessionSchedule schedule;
+        for (std::size_t i = 0; i < N; i++)
+        {
+            schedule.m_steps[i] = table[i];
+        }
+        schedule.m_size = static_cast<int>(N);
+        return schedule;
+    }
+
+    // Work/short break cycles with a long break after every `longBreakInterval`
+    // pomodoros. A plan holds at most MaxSteps steps, so intervals are clamped
+    // to 1..MaxSteps / 2 (16).
+    static SessionSchedule classic(int longBreakInterval);
+
+    // Looks up a built-in plan by settings key, falling back to the classic plan
+    static SessionSchedule builtIn(const QString& name, int longBreakInterval);
+    static QStringList builtInNames();
+
+    // Parses a user plan such as "w10 s3 | w25 s5 w25 s5 w25 l15". Steps before
+    // the '|' run once, the rest repeats. A step without minutes uses the
+    // configured duration for its mode. On failure the classic plan is
+    // returned and `error` says what is wrong with the spec.
+    static SessionSchedule parse(const QString& spec, bool* ok = nullptr, QString* error = nullptr);
+
+    int size() const { return m_size; }
+    const ScheduleStep& step(int index) const { return m_steps[index]; }
+    int next(int index) const { return m_steps[index].next; }
+    int nextWorkStep(int index) const;
+    int firstStepWithMode(SessionMode mode) const;
+
+    bool operator==(const SessionSchedule& other) const;
+    bool operator!=(const SessionSchedule& other) const { return !(*this == other); }
+
+private:
+    void fillClassic(int longBreakInterval);
+
+    std::array<ScheduleStep, MaxSteps> m_steps;
+    int m_size;
+};
+
+#endif // ZIGA_POMODORO_SESSIONSCHEDULE_H
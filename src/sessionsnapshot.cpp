@@ -0,0 +1,172 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "sessionsnapshot.h"
+#include "timer.h"
+#include "sessionrecorder.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+
+namespace
+{
+    constexpr quint32 kSnapshotMagic = 0x5a505353; // "ZPSS"
+    constexpr quint8 kSnapshotVersion = 3; // 2 added pause accounting, 3 the timeline
+}
+
+SessionSnapshotStore::SessionSnapshotStore(Timer* timer, SessionRecorder* recorder, QObject* parent)
+    : QObject(parent)
+      , m_timer(timer)
+      , m_recorder(recorder)
+      , m_savePending(false)
+{
+    QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    m_filePath = QDir(dataPath).filePath("session.snapshot");
+
+    // Every transition ends up here; one write per transition is enough
+    connect(m_timer, &Timer::stateChanged, this, &SessionSnapshotStore::scheduleSave);
+    connect(m_timer, &Timer::modeChanged, this, &SessionSnapshotStore::scheduleSave);
+    connect(m_timer, &Timer::timerCompleted, this, &SessionSnapshotStore::scheduleSave);
+    connect(m_timer, &Timer::pomodorosCompletedChanged, this, &SessionSnapshotStore::scheduleSave);
+}
+
+SessionSnapshotStore::~SessionSnapshotStore()
+{
+    if (m_savePending)
+    {
+        save();
+    }
+}
+
+void SessionSnapshotStore::setFilePath(const QString& path)
+{
+    m_filePath = path;
+}
+
+QString SessionSnapshotStore::getFilePath() const
+{
+    return m_filePath;
+}
+
+bool SessionSnapshotStore::restore()
+{
+    TimerSnapshot snapshot;
+    if (!readSnapshot(m_filePath, &snapshot))
+    {
+        return false;
+    }
+
+    if (m_recorder && snapshot.sessionStartEpochMs != 0)
+    {
+        m_recorder->restoreSession(QDateTime::fromMSecsSinceEpoch(snapshot.sessionStartEpochMs),
+                                   snapshot.pausedMs, snapshot.interruptions, snapshot.timeline);
+    }
+
+    return m_timer->restore(snapshot);
+}
+
+bool SessionSnapshotStore::save()
+{
+    m_savePending = false;
+
+    TimerSnapshot snapshot = m_timer->snapshot();
+    if (m_recorder && m_recorder->sessionStartTime().isValid())
+    {
+        snapshot.sessionStartEpochMs = m_recorder->sessionStartTime().toMSecsSinceEpoch();
+        snapshot.pausedMs = m_recorder->pausedMs();
+        snapshot.interruptions = m_recorder->interruptionCount();
+        snapshot.timeline = m_recorder->timeline();
+    }
+
+    return writeSnapshot(m_filePath, snapshot);
+}
+
+bool SessionSnapshotStore::writeSnapshot(const QString& path, const TimerSnapshot& snapshot)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // QSaveFile writes to a temporary file and renames it over the target on commit
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << kSnapshotMagic << kSnapshotVersion
+        << snapshot.mode << snapshot.state << snapshot.stepIndex
+        << snapshot.pomodorosCompleted
+        << snapshot.deadlineEpochMs << snapshot.remainingMs << snapshot.sessionStartEpochMs
+        << snapshot.pausedMs << snapshot.interruptions << snapshot.timeline;
+
+    return stream.status() == QDataStream::Ok && file.commit();
+}
+
+bool SessionSnapshotStore::readSnapshot(const QString& path, TimerSnapshot* snapshot)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint8 version = 0;
+    stream >> magic >> version;
+    if (magic != kSnapshotMagic || version < 1 || version > kSnapshotVersion)
+    {
+        return false;
+    }
+
+    TimerSnapshot result;
+    stream >> result.mode >> result.state >> result.stepIndex
+        >> result.pomodorosCompleted
+        >> result.deadlineEpochMs >> result.remainingMs >> result.sessionStartEpochMs;
+
+    if (version >= 2)
+    {
+        stream >> result.pausedMs >> result.interruptions;
+    }
+    if (version >= 3)
+    {
+        stream >> result.timeline;
+    }
+
+    // Reject anything Timer::restore() would refuse, so a restore never half-applies
+    if (stream.status() != QDataStream::Ok ||
+        result.mode > static_cast<quint8>(Timer::TimerMode::LongBreak) ||
+        result.state > static_cast<quint8>(Timer::TimerState::Paused))
+    {
+        return false;
+    }
+
+    *snapshot = result;
+    return true;
+}
+
+void SessionSnapshotStore::scheduleSave()
+{
+    if (m_savePending)
+    {
+        return;
+    }
+
+    // Coalesce the signals of one transition into a single write
+    m_savePending = true;
+    QTimer::singleShot(0, this, [this]()
+    {
+        if (m_savePending)
+        {
+            save();
+        }
+    });
+}
@@ -0,0 +1,59 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_SESSIONSNAPSHOT_H
+#define ZIGA_POMODORO_SESSIONSNAPSHOT_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QByteArray>
+
+class Timer;
+class SessionRecorder;
+
+// Engine state needed to resume exactly where a previous run left off
+struct TimerSnapshot
+{
+    quint8 mode = 0;
+    quint8 state = 0;
+    quint8 stepIndex = 0;
+    qint32 pomodorosCompleted = 0;
+    qint64 deadlineEpochMs = 0; // Completion time while running
+    qint64 remainingMs = 0; // Remaining time while paused or stopped
+    qint64 sessionStartEpochMs = 0; // 0 if no session was started
+    qint64 pausedMs = 0; // Time the session spent paused so far
+    qint32 interruptions = 0; // Pauses of the session so far
+    QByteArray timeline; // Encoded SessionTimeline of the session so far
+};
+
+// Writes a compact binary snapshot of the timer on every transition and
+// restores it at startup. Files are replaced atomically.
+class SessionSnapshotStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    SessionSnapshotStore(Timer* timer, SessionRecorder* recorder, QObject* parent = nullptr);
+    ~SessionSnapshotStore() override;
+
+    void setFilePath(const QString& path); // Defaults to the app data directory
+    QString getFilePath() const;
+
+    bool restore();
+    bool save();
+
+    static bool writeSnapshot(const QString& path, const TimerSnapshot& snapshot);
+    static bool readSnapshot(const QString& path, TimerSnapshot* snapshot);
+
+private slots:
+    void scheduleSave();
+
+private:
+    Timer* m_timer;
+    SessionRecorder* m_recorder;
+    QString m_filePath;
+    bool m_savePending;
+};
+
+#endif // ZIGA_POMODORO_SESSIONSNAPSHOT_H
@@ -0,0 +1,122 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "sessiontally.h"
+
+SessionTally::SessionTally()
+    : m_startMs(0)
+      , m_segmentStartMs(0)
+      , m_activeMs(0)
+      , m_pausedMs(0)
+      , m_interruptions(0)
+      , m_mode(SessionMode::Work)
+      , m_endType(SessionEvent::Type::Start)
+      , m_open(false)
+      , m_running(false)
+{
+}
+
+void SessionTally::apply(const SessionEvent& event)
+{
+    switch (event.type)
+    {
+    case SessionEvent::Type::Start:
+        *this = SessionTally();
+        m_open = true;
+        m_running = true;
+        m_mode = event.mode;
+        m_startMs = event.epochMs;
+        m_segmentStartMs = event.epochMs;
+        break;
+
+    case SessionEvent::Type::Pause:
+        if (m_open && m_running)
+        {
+            closeSegment(event.epochMs);
+            m_running = false;
+            m_interruptions++;
+        }
+        break;
+
+    case SessionEvent::Type::Resume:
+        if (m_open && !m_running)
+        {
+            closeSegment(event.epochMs);
+            m_running = true;
+        }
+        break;
+
+    case SessionEvent::Type::Skip:
+    case SessionEvent::Type::Reset:
+    case SessionEvent::Type::Complete:
+        if (m_open)
+        {
+            closeSegment(event.epochMs);
+            m_open = false;
+            m_running = false;
+            m_endType = event.type;
+        }
+        break;
+    }
+}
+
+void SessionTally::restore(qint64 startMs, SessionMode mode, qint64 activeMs, qint64 pausedMs, int interruptions,
+                           bool running, qint64 nowMs)
+{
+    *this = SessionTally();
+    m_open = true;
+    m_running = running;
+    m_mode = mode;
+    m_startMs = startMs;
+    m_segmentStartMs = nowMs;
+    m_activeMs = activeMs;
+    m_pausedMs = pausedMs;
+    m_interruptions = interruptions;
+}
+
+qint64 SessionTally::activeMs(qint64 nowMs) const
+{
+    return m_activeMs + (isRunning() ? qMax<qint64>(0, nowMs - m_segmentStartMs) : 0);
+}
+
+qint64 SessionTally::pausedMs(qint64 nowMs) const
+{
+    return m_pausedMs + (m_open && !m_running ? qMax<qint64>(0, nowMs - m_segmentStartMs) : 0);
+}
+
+QVector<SessionTally> SessionTally::replay(const QVector<SessionEvent>& events)
+{
+    QVector<SessionTally> sessions;
+    SessionTally tally;
+
+    for (const SessionEvent& event : events)
+    {
+        // A Start while open means the closing event never made it to disk
+        if (event.type == SessionEvent::Type::Start && tally.isOpen())
+        {
+            sessions.append(tally);
+        }
+
+        bool wasOpen = tally.isOpen();
+        tally.apply(event);
+        if (wasOpen && !tally.isOpen())
+        {
+            sessions.append(tally);
+        }
+    }
+
+    if (tally.isOpen())
+    {
+        sessions.append(tally);
+    }
+    return sessions;
+}
+
+void SessionTally::closeSegment(qint64 atMs)
+{
+    // Wall-clock time can step backwards; such a segment counts as empty
+    qint64 length = qMax<qint64>(0, atMs - m_segmentStartMs);
+    (m_running ? m_activeMs : m_pausedMs) += length;
+    m_segmentStartMs = qMax(m_segmentStartMs, atMs);
+}
@@ -0,0 +1,58 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_SESSIONTALLY_H
+#define ZIGA_POMODORO_SESSIONTALLY_H
+
+#include <QVector>
+
+#include "sessionevent.h"
+
+// Active time, paused time and interruptions of one session, folded from its
+// SessionEvents. SessionRecorder feeds it exactly the events it appends to
+// the event log, so replaying session_events yields the same totals that
+// were recorded with the session row.
+class SessionTally
+{
+public:
+    SessionTally();
+
+    // Start opens a session; Pause and Resume split it into segments; Skip,
+    // Reset and Complete close it. Events that do not fit the state are ignored.
+    void apply(const SessionEvent& event);
+
+    // Continues a session carried across a restart
+    void restore(qint64 startMs, SessionMode mode, qint64 activeMs, qint64 pausedMs, int interruptions,
+                 bool running, qint64 nowMs);
+
+    bool isOpen() const { return m_open; }
+    bool isRunning() const { return m_open && m_running; }
+    qint64 startMs() const { return m_startMs; }
+    SessionMode mode() const { return m_mode; }
+    SessionEvent::Type endType() const { return m_endType; } // Closing event of a closed session
+    int interruptions() const { return m_interruptions; }
+
+    // Totals so far; the open segment counts up to nowMs
+    qint64 activeMs(qint64 nowMs) const;
+    qint64 pausedMs(qint64 nowMs) const;
+
+    // One tally per session in an event stream, oldest first. A session still
+    // open at the end of the stream is returned open.
+    static QVector<SessionTally> replay(const QVector<SessionEvent>& events);
+
+private:
+    void closeSegment(qint64 atMs);
+
+    qint64 m_startMs;
+    qint64 m_segmentStartMs;
+    qint64 m_activeMs; // Closed active segments
+    qint64 m_pausedMs; // Closed paused segments
+    int m_interruptions;
+    SessionMode m_mode;
+    SessionEvent::Type m_endType;
+    bool m_open;
+    bool m_running;
+};
+
+#endif // ZIGA_POMODORO_SESSIONTALLY_H
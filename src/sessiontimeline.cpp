@@ -0,0 +1,149 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "sessiontimeline.h"
+
+void SessionTimeline::Summary::add(const Summary& other)
+{
+    sessions += other.sessions;
+    pauses += other.pauses;
+    skips += other.skips;
+    activeSeconds += other.activeSeconds;
+    pausedSeconds += other.pausedSeconds;
+    longestFocusSeconds = qMax(longestFocusSeconds, other.longestFocusSeconds);
+    corrupt += other.corrupt;
+}
+
+SessionTimeline::SessionTimeline()
+    : m_lastOffset(0)
+{
+}
+
+void SessionTimeline::clear()
+{
+    m_data.clear();
+    m_lastOffset = 0;
+}
+
+void SessionTimeline::append(SessionEvent::Type type, qint32 offsetSeconds)
+{
+    // Offsets never go backwards, even if the wall clock does
+    qint32 delta = qBound(0, offsetSeconds - m_lastOffset, 0x1fffffff);
+    m_lastOffset += delta;
+    appendVarint(&m_data, (static_cast<quint32>(delta) << 3) | static_cast<quint32>(type));
+}
+
+bool SessionTimeline::isEmpty() const
+{
+    return m_data.isEmpty();
+}
+
+QByteArray SessionTimeline::encoded() const
+{
+    return m_data;
+}
+
+SessionTimeline SessionTimeline::fromEncoded(const QByteArray& blob, bool* ok)
+{
+    SessionTimeline timeline;
+    qint32 lastOffset = 0;
+    bool valid = forEachMark(blob, [&lastOffset](const Mark& mark)
+    {
+        lastOffset = mark.offsetSeconds;
+    });
+
+    if (valid)
+    {
+        timeline.m_data = blob;
+        timeline.m_lastOffset = lastOffset;
+    }
+    if (ok)
+    {
+        *ok = valid;
+    }
+    return timeline;
+}
+
+bool SessionTimeline::decode(const QByteArray& blob, QVector<Mark>* marks)
+{
+    marks->clear();
+    marks->reserve(blob.size()); // At least one byte per mark
+    return forEachMark(blob, [marks](const Mark& mark)
+    {
+        marks->append(mark);
+    });
+}
+
+SessionTimeline::Summary SessionTimeline::summarize(const QByteArray& blob)
+{
+    Summary summary;
+    summary.sessions = 1;
+
+    bool running = true;
+    qint32 segmentStart = 0;
+
+    bool valid = forEachMark(blob, [&](const Mark& mark)
+    {
+        qint32 length = mark.offsetSeconds - segmentStart;
+        segmentStart = mark.offsetSeconds;
+
+        if (running)
+        {
+            summary.activeSeconds += length;
+            summary.longestFocusSeconds = qMax(summary.longestFocusSeconds, length);
+        }
+        else
+        {
+            summary.pausedSeconds += length;
+        }
+
+        switch (mark.type)
+        {
+        case SessionEvent::Type::Pause:
+            summary.pauses++;
+            running = false;
+            break;
+        case SessionEvent::Type::Resume:
+        case SessionEvent::Type::Start:
+            running = true;
+            break;
+        case SessionEvent::Type::Skip:
+            summary.skips++;
+            break;
+        case SessionEvent::Type::Reset:
+        case SessionEvent::Type::Complete:
+            break;
+        }
+    });
+
+    if (!valid)
+    {
+        Summary corrupt;
+        corrupt.sessions = 1;
+        corrupt.corrupt = 1;
+        return corrupt;
+    }
+
+    return summary;
+}
+
+SessionTimeline::Summary SessionTimeline::summarize(const QVector<QByteArray>& blobs)
+{
+    Summary total;
+    for (const QByteArray& blob : blobs)
+    {
+        total.add(summarize(blob));
+    }
+    return total;
+}
+
+void SessionTimeline::appendVarint(QByteArray* out, quint32 value)
+{
+    while (value >= 0x80)
+    {
+        out->append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out->append(static_cast<char>(value));
+}
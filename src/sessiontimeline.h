@@ -0,0 +1,102 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_SESSIONTIMELINE_H
+#define ZIGA_POMODORO_SESSIONTIMELINE_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "sessionevent.h"
+
+// Where a single session was interrupted, stored as one small blob per session.
+// Each mark is a varint of (seconds since the previous mark << 3 | event type);
+// the session start is implicit at offset 0. A session with a couple of pauses
+// takes well under ten bytes.
+class SessionTimeline
+{
+public:
+    struct Mark
+    {
+        qint32 offsetSeconds; // Since the start of the session
+        SessionEvent::Type type;
+    };
+
+    // Derived from the marks in a single pass
+    struct Summary
+    {
+        int sessions = 0;
+        int pauses = 0;
+        int skips = 0;
+        qint64 activeSeconds = 0;
+        qint64 pausedSeconds = 0;
+        qint32 longestFocusSeconds = 0; // Longest uninterrupted active stretch
+        int corrupt = 0; // Blobs that could not be decoded
+
+        void add(const Summary& other);
+    };
+
+    SessionTimeline();
+
+    // Building
+    void clear();
+    void append(SessionEvent::Type type, qint32 offsetSeconds);
+    bool isEmpty() const;
+    QByteArray encoded() const;
+    static SessionTimeline fromEncoded(const QByteArray& blob, bool* ok = nullptr);
+
+    // Decoding
+    static bool decode(const QByteArray& blob, QVector<Mark>* marks);
+    static Summary summarize(const QByteArray& blob);
+    static Summary summarize(const QVector<QByteArray>& blobs);
+
+    // Calls visit(const Mark&) for every mark without allocating; false if the blob is malformed
+    template <typename Visitor>
+    static bool forEachMark(const QByteArray& blob, Visitor visit);
+
+private:
+    static void appendVarint(QByteArray* out, quint32 value);
+
+    QByteArray m_data;
+    qint32 m_lastOffset;
+};
+
+template <typename Visitor>
+bool SessionTimeline::forEachMark(const QByteArray& blob, Visitor visit)
+{
+    const auto* data = reinterpret_cast<const uchar*>(blob.constData());
+    const uchar* end = data + blob.size();
+    qint64 offset = 0;
+
+    while (data < end)
+    {
+        quint32 value = 0;
+        int shift = 0;
+        uchar byte;
+        do
+        {
+            if (data == end || shift > 28)
+            {
+                return false;
+            }
+            byte = *data++;
+            value |= static_cast<quint32>(byte & 0x7f) << shift;
+            shift += 7;
+        }
+        while (byte & 0x80);
+
+        quint32 type = value & 0x7;
+        if (type > static_cast<quint32>(SessionEvent::Type::Complete))
+        {
+            return false;
+        }
+
+        offset += value >> 3;
+        visit(Mark{static_cast<qint32>(offset), static_cast<SessionEvent::Type>(type)});
+    }
+
+    return true;
+}
+
+#endif // ZIGA_POMODORO_SESSIONTIMELINE_H
@@ -7,6 +7,7 @@
 #include <QJsonParseError>
 #include <QDir>
 #include <QStandardPaths> // For getting standard paths
+#include <QDebug>
 
 
 // In the Settings constructor, add these initializations:
@@ -17,12 +18,15 @@ Settings::Settings(QObject* parent)
       , m_shortBreakDuration(5)
       , m_longBreakDuration(15)
       , m_longBreakInterval(4)
+      , m_schedulePlan("classic")
       , m_soundEnabled(true)
       , m_soundFile(":/sounds/alarm.wav")
       , m_desktopNotificationsEnabled(true)
       , m_theme("default")
       , m_minimizeToTray(false)
       , m_startMinimized(false)
+      , m_shapeMaskEnabled(false)
+      , m_progressRingEnabled(true)
       , m_fontSize(48)
       , m_fontColor("#FFFFFF") // White
       , m_textShadowEnabled(false)
@@ -198,6 +202,53 @@ void Settings::setLongBreakInterval(int count)
     }
 }
 
+QString Settings::getSchedulePlan() const
+{
+    return m_schedulePlan;
+}
+
+QString Settings::getCustomSchedule() const
+{
+    return m_customSchedule;
+}
+
+SessionSchedule Settings::getSessionSchedule() const
+{
+    if (m_schedulePlan == "custom")
+    {
+        bool ok = false;
+        QString error;
+        SessionSchedule schedule = SessionSchedule::parse(m_customSchedule, &ok, &error);
+        if (ok)
+        {
+            return schedule;
+        }
+
+        // The settings dialog rejects invalid plans; this is a hand-edited file
+        qWarning() << "Invalid custom session plan, using the classic plan:" << error;
+    }
+
+    return SessionSchedule::builtIn(m_schedulePlan, m_longBreakInterval);
+}
+
+void Settings::setSchedulePlan(const QString& plan)
+{
+    if (m_schedulePlan != plan)
+    {
+        m_schedulePlan = plan;
+        emit settingsChanged();
+    }
+}
+
+void Settings::setCustomSchedule(const QString& spec)
+{
+    if (m_customSchedule != spec)
+    {
+        m_customSchedule = spec;
+        emit settingsChanged();
+    }
+}
+
 bool Settings::getSoundEnabled() const
 {
     return m_soundEnabled;
@@ -255,6 +306,16 @@ bool Settings::getStartMinimized() const
     return m_startMinimized;
 }
 
+bool Settings::getProgressRingEnabled() const
+{
+    return m_progressRingEnabled;
+}
+
+bool Settings::getShapeMaskEnabled() const
+{
+    return m_shapeMaskEnabled;
+}
+
 void Settings::setTheme(const QString& theme)
 {
     if (m_theme != theme)
@@ -282,12 +343,32 @@ void Settings::setStartMinimized(bool enabled)
     }
 }
 
+void Settings::setProgressRingEnabled(bool enabled)
+{
+    if (m_progressRingEnabled != enabled)
+    {
+        m_progressRingEnabled = enabled;
+        emit settingsChanged();
+    }
+}
+
+void Settings::setShapeMaskEnabled(bool enabled)
+{
+    if (m_shapeMaskEnabled != enabled)
+    {
+        m_shapeMaskEnabled = enabled;
+        emit settingsChanged();
+    }
+}
+
 void Settings::loadSettings()
 {
     m_workDuration = m_settings.value("timer/workDuration", 25).toInt();
     m_shortBreakDuration = m_settings.value("timer/shortBreakDuration", 5).toInt();
     m_longBreakDuration = m_settings.value("timer/longBreakDuration", 15).toInt();
     m_longBreakInterval = m_settings.value("timer/longBreakInterval", 4).toInt();
+    m_schedulePlan = m_settings.value("timer/schedulePlan", "classic").toString();
+    m_customSchedule = m_settings.value("timer/customSchedule", "").toString();
 
     m_soundEnabled = m_settings.value("notifications/soundEnabled", true).toBool();
     m_soundFile = m_settings.value("notifications/soundFile", ":/sounds/alarm.wav").toString();
@@ -296,6 +377,8 @@ void Settings::loadSettings()
     m_theme = m_settings.value("ui/theme", "default").toString();
     m_minimizeToTray = m_settings.value("ui/minimizeToTray", false).toBool();
     m_startMinimized = m_settings.value("ui/startMinimized", false).toBool();
+    m_shapeMaskEnabled = m_settings.value("ui/shapeMaskEnabled", false).toBool();
+    m_progressRingEnabled = m_settings.value("ui/progressRingEnabled", true).toBool();
 
 
     m_fontSize = m_settings.value("ui/fontSize", 48).toInt();
@@ -314,6 +397,8 @@ void Settings::saveSettings()
     m_settings.setValue("timer/shortBreakDuration", m_shortBreakDuration);
     m_settings.setValue("timer/longBreakDuration", m_longBreakDuration);
     m_settings.setValue("timer/longBreakInterval", m_longBreakInterval);
+    m_settings.setValue("timer/schedulePlan", m_schedulePlan);
+    m_settings.setValue("timer/customSchedule", m_customSchedule);
 
     m_settings.setValue("notifications/soundEnabled", m_soundEnabled);
     m_settings.setValue("notifications/soundFile", m_soundFile);
@@ -322,6 +407,8 @@ void Settings::saveSettings()
     m_settings.setValue("ui/theme", m_theme);
     m_settings.setValue("ui/minimizeToTray", m_minimizeToTray);
     m_settings.setValue("ui/startMinimized", m_startMinimized);
+    m_settings.setValue("ui/shapeMaskEnabled", m_shapeMaskEnabled);
+    m_settings.setValue("ui/progressRingEnabled", m_progressRingEnabled);
 
     m_settings.setValue("ui/fontSize", m_fontSize);
     m_settings.setValue("ui/fontColor", m_fontColor);
@@ -341,6 +428,8 @@ void Settings::resetToDefaults()
     m_shortBreakDuration = 5;
     m_longBreakDuration = 15;
     m_longBreakInterval = 4;
+    m_schedulePlan = "classic";
+    m_customSchedule.clear();
 
     m_soundEnabled = true;
     m_soundFile = ":/sounds/alarm.wav";
@@ -349,6 +438,8 @@ void Settings::resetToDefaults()
     m_theme = "default";
     m_minimizeToTray = false;
     m_startMinimized = false;
+    m_shapeMaskEnabled = false;
+    m_progressRingEnabled = true;
 
     m_fontSize = 48;
     m_fontColor = "#FFFFFF";
@@ -8,6 +8,8 @@
 #include <QObject>
 #include <QSettings>
 
+#include "sessionschedule.h"
+
 class Settings : public QObject
 {
     Q_OBJECT
@@ -27,6 +29,14 @@ public:
     void setLongBreakDuration(int minutes);
     void setLongBreakInterval(int count);
 
+    // Session plan ("classic", a built-in name, or "custom")
+    QString getSchedulePlan() const;
+    QString getCustomSchedule() const;
+    SessionSchedule getSessionSchedule() const;
+
+    void setSchedulePlan(const QString& plan);
+    void setCustomSchedule(const QString& spec);
+
     // Notification settings
     bool getSoundEnabled() const;
     QString getSoundFile() const;
@@ -40,10 +50,14 @@ public:
     QString getTheme() const;
     bool getMinimizeToTray() const;
     bool getStartMinimized() const;
+    bool getShapeMaskEnabled() const;
+    bool getProgressRingEnabled() const;
 
     void setTheme(const QString& theme);
     void setMinimizeToTray(bool enabled);
     void setStartMinimized(bool enabled);
+    void setShapeMaskEnabled(bool enabled);
+    void setProgressRingEnabled(bool enabled);
 
     // Font settings
     int getFontSize() const;
@@ -79,6 +93,8 @@ private:
     int m_shortBreakDuration;
     int m_longBreakDuration;
     int m_longBreakInterval;
+    QString m_schedulePlan;
+    QString m_customSchedule;
 
     // Notification settings
     bool m_soundEnabled;
@@ -89,6 +105,8 @@ private:
     QString m_theme;
     bool m_minimizeToTray;
     bool m_startMinimized;
+    bool m_shapeMaskEnabled;
+    bool m_progressRingEnabled;
 
     int m_fontSize;
     QString m_fontColor;
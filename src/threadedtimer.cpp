@@ -0,0 +1,287 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "threadedtimer.h"
+#include "databasemanager.h"
+#include "sessionrecorder.h"
+#include "sessionsnapshot.h"
+
+template <typename Function>
+void ThreadedTimer::runOnEngine(Function function, Qt::ConnectionType type) const
+{
+    QMetaObject::invokeMethod(m_engine, std::move(function), type);
+}
+
+ThreadedTimer::ThreadedTimer(QObject* parent)
+    : QObject(parent)
+      , m_engine(new Timer())
+      , m_recorder(nullptr)
+      , m_snapshotStore(nullptr)
+      , m_engineDb(nullptr)
+      , m_tickConsumerVisible(true)
+      , m_lastDeliveredSeconds(-1)
+{
+    qRegisterMetaType<RecordedSession>();
+
+    m_thread.setObjectName("TimerEngine");
+    m_engine->moveToThread(&m_thread);
+    m_thread.start(QThread::HighPriority);
+
+    runOnEngine([this]()
+    {
+        m_recorder = new SessionRecorder(m_engine);
+        m_snapshotStore = new SessionSnapshotStore(m_engine, m_recorder);
+
+        // Publish from the engine thread as things happen
+        connect(m_engine, &Timer::timerTick, m_engine, [this](int)
+        {
+            publishState();
+        });
+        connect(m_engine, &Timer::stateChanged, m_engine, [this](Timer::TimerState state)
+        {
+            publishEvent(TimerEvent::Kind::StateChanged, static_cast<quint8>(state));
+        });
+        connect(m_engine, &Timer::modeChanged, m_engine, [this](Timer::TimerMode mode)
+        {
+            publishEvent(TimerEvent::Kind::ModeChanged, static_cast<quint8>(mode));
+        });
+        connect(m_engine, &Timer::timerCompleted, m_engine, [this](Timer::TimerMode mode)
+        {
+            publishEvent(TimerEvent::Kind::Completed, static_cast<quint8>(mode));
+        });
+        connect(m_engine, &Timer::pomodorosCompletedChanged, m_engine, [this](int count)
+        {
+            publishEvent(TimerEvent::Kind::PomodorosCompleted, 0, count);
+        });
+
+        publishState();
+    }, Qt::BlockingQueuedConnection);
+}
+
+ThreadedTimer::~ThreadedTimer()
+{
+    // Tear the engine down on its own thread
+    runOnEngine([this]()
+    {
+        delete m_snapshotStore;
+        delete m_recorder;
+        delete m_engine;
+        delete m_engineDb;
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void ThreadedTimer::start()
+{
+    runOnEngine([this]() { m_engine->start(); });
+}
+
+void ThreadedTimer::pause()
+{
+    runOnEngine([this]() { m_engine->pause(); });
+}
+
+void ThreadedTimer::reset()
+{
+    runOnEngine([this]() { m_engine->reset(); });
+}
+
+void ThreadedTimer::skipBreak()
+{
+    runOnEngine([this]() { m_engine->skipBreak(); });
+}
+
+void ThreadedTimer::skipToNext()
+{
+    runOnEngine([this]() { m_engine->skipToNext(); });
+}
+
+void ThreadedTimer::stopSession()
+{
+    runOnEngine([this]()
+    {
+        m_recorder->recordInterrupted();
+        m_engine->reset();
+    });
+}
+
+Timer::TimerState ThreadedTimer::getState() const
+{
+    return static_cast<Timer::TimerState>(m_channel.latestState().state);
+}
+
+Timer::TimerMode ThreadedTimer::getMode() const
+{
+    return static_cast<Timer::TimerMode>(m_channel.latestState().mode);
+}
+
+int ThreadedTimer::getRemainingTime() const
+{
+    return m_channel.latestState().remainingSeconds;
+}
+
+int ThreadedTimer::getSessionDuration() const
+{
+    return m_channel.latestState().sessionDuration;
+}
+
+int ThreadedTimer::getTotalCompletedPomodoros() const
+{
+    return m_channel.latestState().pomodorosCompleted;
+}
+
+void ThreadedTimer::setWorkDuration(int minutes)
+{
+    runOnEngine([this, minutes]() { m_engine->setWorkDuration(minutes); });
+}
+
+void ThreadedTimer::setShortBreakDuration(int minutes)
+{
+    runOnEngine([this, minutes]() { m_engine->setShortBreakDuration(minutes); });
+}
+
+void ThreadedTimer::setLongBreakDuration(int minutes)
+{
+    runOnEngine([this, minutes]() { m_engine->setLongBreakDuration(minutes); });
+}
+
+void ThreadedTimer::setSchedule(const SessionSchedule& schedule)
+{
+    runOnEngine([this, schedule]() { m_engine->setSchedule(schedule); });
+}
+
+void ThreadedTimer::setTickConsumerVisible(bool visible)
+{
+    if (m_tickConsumerVisible == visible)
+    {
+        return;
+    }
+
+    m_tickConsumerVisible = visible;
+    runOnEngine([this, visible]() { m_engine->setTickConsumerVisible(visible); });
+}
+
+bool ThreadedTimer::isTickConsumerVisible() const
+{
+    return m_tickConsumerVisible;
+}
+
+void ThreadedTimer::setDatabaseManager(DatabaseManager* dbManager)
+{
+    QString databasePath = (dbManager && dbManager->isInitialized()) ? dbManager->getDatabasePath() : QString();
+
+    runOnEngine([this, databasePath]()
+    {
+        m_recorder->setDatabaseManager(nullptr);
+        delete m_engineDb;
+        m_engineDb = nullptr;
+
+        if (databasePath.isEmpty())
+        {
+            return;
+        }
+
+        // SQLite connections are per thread, so the engine gets its own
+        m_engineDb = new DatabaseManager();
+        m_engineDb->setConnectionName("timer-engine");
+        m_engineDb->setDatabasePath(databasePath);
+        if (m_engineDb->initialize())
+        {
+            m_recorder->setDatabaseManager(m_engineDb);
+
+            // Only this connection records, so the views hear about sessions from here
+            connect(m_engineDb, &DatabaseManager::sessionRecorded, this, &ThreadedTimer::sessionRecorded,
+                    Qt::QueuedConnection);
+        }
+    });
+}
+
+bool ThreadedTimer::restoreSnapshot()
+{
+    bool restored = false;
+    runOnEngine([this, &restored]()
+    {
+        restored = m_snapshotStore->restore();
+    }, Qt::BlockingQueuedConnection);
+
+    // Make the restored state visible right away
+    drainChannel();
+    return restored;
+}
+
+quint64 ThreadedTimer::getWakeupCount() const
+{
+    quint64 count = 0;
+    runOnEngine([this, &count]() { count = m_engine->getWakeupCount(); }, Qt::BlockingQueuedConnection);
+    return count;
+}
+
+double ThreadedTimer::getWakeupsPerMinute() const
+{
+    double rate = 0.0;
+    runOnEngine([this, &rate]() { rate = m_engine->getWakeupsPerMinute(); }, Qt::BlockingQueuedConnection);
+    return rate;
+}
+
+quint64 ThreadedTimer::getDroppedEvents() const
+{
+    return m_channel.droppedEvents();
+}
+
+void ThreadedTimer::publishState()
+{
+    TickChannel::State state;
+    state.remainingSeconds = m_engine->getRemainingTime();
+    state.mode = static_cast<quint8>(m_engine->getMode());
+    state.state = static_cast<quint8>(m_engine->getState());
+    state.pomodorosCompleted = m_engine->getTotalCompletedPomodoros();
+    state.sessionDuration = m_engine->getSessionDuration();
+    m_channel.publishState(state);
+
+    if (m_channel.requestWake())
+    {
+        QMetaObject::invokeMethod(this, [this]() { drainChannel(); }, Qt::QueuedConnection);
+    }
+}
+
+void ThreadedTimer::publishEvent(TimerEvent::Kind kind, quint8 value, int count)
+{
+    m_channel.pushEvent(TimerEvent{kind, value, count});
+    publishState();
+}
+
+void ThreadedTimer::drainChannel()
+{
+    m_channel.acknowledgeWake();
+
+    TimerEvent event;
+    while (m_channel.popEvent(&event))
+    {
+        switch (event.kind)
+        {
+        case TimerEvent::Kind::StateChanged:
+            emit stateChanged(static_cast<Timer::TimerState>(event.value));
+            break;
+        case TimerEvent::Kind::ModeChanged:
+            emit modeChanged(static_cast<Timer::TimerMode>(event.value));
+            break;
+        case TimerEvent::Kind::Completed:
+            emit timerCompleted(static_cast<Timer::TimerMode>(event.value));
+            break;
+        case TimerEvent::Kind::PomodorosCompleted:
+            emit pomodorosCompletedChanged(event.count);
+            break;
+        }
+    }
+
+    // Ticks are latest-value: only the newest one matters
+    int remaining = getRemainingTime();
+    if (remaining != m_lastDeliveredSeconds)
+    {
+        m_lastDeliveredSeconds = remaining;
+        emit timerTick(remaining);
+    }
+}
@@ -0,0 +1,94 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_THREADEDTIMER_H
+#define ZIGA_POMODORO_THREADEDTIMER_H
+
+#include <QObject>
+#include <QThread>
+
+#include "timer.h"
+#include "tickchannel.h"
+#include "databasemanager.h" // RecordedSession
+
+class SessionRecorder;
+class SessionSnapshotStore;
+
+// UI-thread facade over a Timer running on its own thread. Commands are
+// queued to the engine; ticks and transitions come back through a lock-free
+// TickChannel, so a stalled GUI never delays completion or recording.
+// Session recording and snapshots happen on the engine thread.
+class ThreadedTimer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ThreadedTimer(QObject* parent = nullptr);
+    ~ThreadedTimer() override;
+
+    void start();
+    void pause();
+    void reset();
+    void skipBreak();
+    void skipToNext();
+
+    // Records the current work session as interrupted, then resets
+    void stopSession();
+
+    // Latest state published by the engine
+    Timer::TimerState getState() const;
+    Timer::TimerMode getMode() const;
+    int getRemainingTime() const;
+    int getSessionDuration() const;
+    int getTotalCompletedPomodoros() const;
+
+    void setWorkDuration(int minutes);
+    void setShortBreakDuration(int minutes);
+    void setLongBreakDuration(int minutes);
+    void setSchedule(const SessionSchedule& schedule);
+
+    void setTickConsumerVisible(bool visible);
+    bool isTickConsumerVisible() const;
+
+    // Opens a separate connection to the same database for the engine thread
+    void setDatabaseManager(DatabaseManager* dbManager);
+
+    // Blocks until the previous session, if any, is restored on the engine
+    bool restoreSnapshot();
+
+    quint64 getWakeupCount() const;
+    double getWakeupsPerMinute() const;
+    quint64 getDroppedEvents() const;
+
+signals:
+    void timerTick(int remainingSeconds);
+    void timerCompleted(Timer::TimerMode completedMode);
+    void modeChanged(Timer::TimerMode newMode);
+    void stateChanged(Timer::TimerState newState);
+    void pomodorosCompletedChanged(int count);
+    void sessionRecorded(const RecordedSession& session); // Committed by the engine's connection
+
+private:
+    // Engine thread
+    void publishState();
+    void publishEvent(TimerEvent::Kind kind, quint8 value, int count = 0);
+
+    // UI thread
+    void drainChannel();
+
+    template <typename Function>
+    void runOnEngine(Function function, Qt::ConnectionType type = Qt::QueuedConnection) const;
+
+    QThread m_thread;
+    Timer* m_engine;
+    SessionRecorder* m_recorder;
+    SessionSnapshotStore* m_snapshotStore;
+    DatabaseManager* m_engineDb;
+    TickChannel m_channel;
+
+    bool m_tickConsumerVisible;
+    int m_lastDeliveredSeconds;
+};
+
+#endif // ZIGA_POMODORO_THREADEDTIMER_H
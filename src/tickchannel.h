@@ -0,0 +1,141 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_TICKCHANNEL_H
+#define ZIGA_POMODORO_TICKCHANNEL_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+
+// Transition published by the timer engine thread
+struct TimerEvent
+{
+    enum class Kind : quint8
+    {
+        StateChanged,
+        ModeChanged,
+        Completed,
+        PomodorosCompleted
+    };
+
+    Kind kind;
+    quint8 value; // State or mode, depending on kind
+    qint32 count;
+};
+
+// Lock-free single-producer/single-consumer channel from the engine thread to
+// the UI. Ticks are latest-value: the consumer only ever sees the newest
+// engine state word. Transitions go through a bounded ring so none are lost
+// while the UI is busy.
+class TickChannel
+{
+public:
+    static constexpr quint32 Capacity = 256;
+
+    // Engine state, packed into one word so a reader never pairs the fields
+    // of two different publishes: 20 bits each for the remaining seconds and
+    // the session duration (about 12 days), 4 each for mode and state, and
+    // 16 for the completed count
+    struct State
+    {
+        int remainingSeconds;
+        quint8 mode;
+        quint8 state;
+        int pomodorosCompleted;
+        int sessionDuration;
+    };
+
+    TickChannel()
+        : m_latest(0)
+          , m_head(0)
+          , m_tail(0)
+          , m_wakePending(false)
+          , m_dropped(0)
+    {
+    }
+
+    // Producer side
+    void publishState(const State& state)
+    {
+        quint64 word = (quint64(qBound(0, state.remainingSeconds, kSecondsMask)) << 44)
+            | (quint64(qBound(0, state.sessionDuration, kSecondsMask)) << 24)
+            | (quint64(state.mode & 0xF) << 20)
+            | (quint64(state.state & 0xF) << 16)
+            | quint64(qBound(0, state.pomodorosCompleted, 0xFFFF));
+        m_latest.store(word, std::memory_order_release);
+    }
+
+    bool pushEvent(const TimerEvent& event)
+    {
+        quint32 head = m_head.load(std::memory_order_relaxed);
+        quint32 tail = m_tail.load(std::memory_order_acquire);
+        if (head - tail == Capacity)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_ring[head % Capacity] = event;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns true if the consumer has to be woken up; wakeups are coalesced
+    // until the consumer acknowledges them
+    bool requestWake()
+    {
+        return !m_wakePending.exchange(true, std::memory_order_acq_rel);
+    }
+
+    // Consumer side
+    void acknowledgeWake()
+    {
+        m_wakePending.store(false, std::memory_order_release);
+    }
+
+    bool popEvent(TimerEvent* event)
+    {
+        quint32 tail = m_tail.load(std::memory_order_relaxed);
+        quint32 head = m_head.load(std::memory_order_acquire);
+        if (tail == head)
+        {
+            return false;
+        }
+
+        *event = m_ring[tail % Capacity];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    State latestState() const
+    {
+        quint64 word = m_latest.load(std::memory_order_acquire);
+
+        State state;
+        state.remainingSeconds = static_cast<int>(word >> 44);
+        state.sessionDuration = static_cast<int>((word >> 24) & kSecondsMask);
+        state.mode = static_cast<quint8>((word >> 20) & 0xF);
+        state.state = static_cast<quint8>((word >> 16) & 0xF);
+        state.pomodorosCompleted = static_cast<int>(word & 0xFFFF);
+        return state;
+    }
+
+    quint64 droppedEvents() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr int kSecondsMask = 0xFFFFF;
+
+    std::atomic<quint64> m_latest;
+    std::array<TimerEvent, Capacity> m_ring;
+    alignas(64) std::atomic<quint32> m_head; // Written by the producer
+    alignas(64) std::atomic<quint32> m_tail; // Written by the consumer
+    alignas(64) std::atomic<bool> m_wakePending;
+    std::atomic<quint64> m_dropped;
+};
+
+#endif // ZIGA_POMODORO_TICKCHANNEL_H
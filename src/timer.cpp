@@ -3,35 +3,51 @@
 //
 
 #include "timer.h"
+#include "trace.h"
+
+namespace
+{
+    // Coarse timers may fire a few percent early; a wakeup this close to a
+    // second boundary is treated as having reached it
+    constexpr qint64 kTickSlackMs = 50;
+}
 
 Timer::Timer(QObject* parent)
     : QObject(parent)
       , m_timer(new QTimer(this))
+      , m_clock(Clock::instance())
+      , m_simulatedWakeup(0)
       , m_state(TimerState::Stopped)
       , m_mode(TimerMode::Work)
-      , m_remainingSeconds(25 * 60) // Default: 25 minutes
-      , m_elapsedSeconds(0)
+      , m_deadlineMs(0)
+      , m_remainingMs(25 * 60 * 1000) // Default: 25 minutes
+      , m_sessionDuration(25 * 60)
       , m_workDuration(25 * 60) // Default: 25 minutes
       , m_shortBreakDuration(5 * 60) // Default: 5 minutes
       , m_longBreakDuration(15 * 60) // Default: 15 minutes
-      , m_longBreakInterval(4) // Default: Every 4 pomodoros
       , m_pomodorosCompleted(0)
+      , m_schedule(SessionSchedule::classic(4)) // Default: Long break every 4 pomodoros
+      , m_stepIndex(0)
+      , m_tickConsumerVisible(true)
+      , m_wakeupCount(0)
+      , m_wakeupWindowStartMs(m_clock->monotonicMs())
 {
     connect(m_timer, &QTimer::timeout, this, &Timer::onTimeout);
-    m_timer->setInterval(1000); // 1 second interval
+    m_timer->setSingleShot(true); // Every wakeup is armed explicitly
 }
 
 Timer::~Timer()
 {
-    m_timer->stop();
+    cancelWakeup();
 }
 
 void Timer::start()
 {
     if (m_state != TimerState::Running)
     {
-        m_timer->start();
+        armDeadline();
         m_state = TimerState::Running;
+        scheduleWakeup();
         emit stateChanged(m_state);
     }
 }
@@ -40,7 +56,8 @@ void Timer::pause()
 {
     if (m_state == TimerState::Running)
     {
-        m_timer->stop();
+        m_remainingMs = remainingMs();
+        cancelWakeup();
         m_state = TimerState::Paused;
         emit stateChanged(m_state);
     }
@@ -48,18 +65,18 @@ void Timer::pause()
 
 void Timer::reset()
 {
-    m_timer->stop();
+    cancelWakeup();
     m_state = TimerState::Stopped;
     resetTimerForCurrentMode();
-    m_elapsedSeconds = 0;
     emit stateChanged(m_state);
-    emit timerTick(m_remainingSeconds);
+    emit timerTick(getRemainingTime());
 }
 
 void Timer::skipToNext()
 {
-    m_timer->stop();
+    cancelWakeup();
     m_state = TimerState::Stopped;
+    TimerMode skippedMode = m_mode;
 
     // Complete current timer
     if (m_mode == TimerMode::Work)
@@ -68,7 +85,9 @@ void Timer::skipToNext()
         emit pomodorosCompletedChanged(m_pomodorosCompleted);
     }
 
+    // Listeners see the timer already on the next session, as with skipBreak()
     switchToNextMode();
+    emit sessionSkipped(skippedMode);
     emit stateChanged(m_state);
 }
 
@@ -84,12 +103,17 @@ Timer::TimerMode Timer::getMode() const
 
 int Timer::getRemainingTime() const
 {
-    return m_remainingSeconds;
+    return secondsFromMs(remainingMs());
 }
 
 int Timer::getElapsedTime() const
 {
-    return m_elapsedSeconds;
+    return qMax(0, m_sessionDuration - getRemainingTime());
+}
+
+int Timer::getSessionDuration() const
+{
+    return m_sessionDuration;
 }
 
 int Timer::getTotalCompletedPomodoros() const
@@ -102,8 +126,7 @@ void Timer::setWorkDuration(int minutes)
     m_workDuration = minutes * 60;
     if (m_mode == TimerMode::Work && m_state == TimerState::Stopped)
     {
-        m_remainingSeconds = m_workDuration;
-        emit timerTick(m_remainingSeconds);
+        resetTimerForCurrentMode();
     }
 }
 
@@ -112,8 +135,7 @@ void Timer::setShortBreakDuration(int minutes)
     m_shortBreakDuration = minutes * 60;
     if (m_mode == TimerMode::ShortBreak && m_state == TimerState::Stopped)
     {
-        m_remainingSeconds = m_shortBreakDuration;
-        emit timerTick(m_remainingSeconds);
+        resetTimerForCurrentMode();
     }
 }
 
@@ -122,78 +144,227 @@ void Timer::setLongBreakDuration(int minutes)
     m_longBreakDuration = minutes * 60;
     if (m_mode == TimerMode::LongBreak && m_state == TimerState::Stopped)
     {
-        m_remainingSeconds = m_longBreakDuration;
-        emit timerTick(m_remainingSeconds);
+        resetTimerForCurrentMode();
     }
 }
 
-void Timer::setLongBreakInterval(int count)
+void Timer::setSchedule(const SessionSchedule& schedule)
 {
-    m_longBreakInterval = count;
+    if (m_schedule == schedule)
+    {
+        return;
+    }
+
+    m_schedule = schedule;
+
+    // Continue from the first step of the new plan matching the current mode
+    m_stepIndex = m_schedule.firstStepWithMode(m_mode);
+    if (m_schedule.step(m_stepIndex).mode != m_mode)
+    {
+        m_mode = m_schedule.step(m_stepIndex).mode;
+        emit modeChanged(m_mode);
+    }
+
+    if (m_state == TimerState::Stopped)
+    {
+        resetTimerForCurrentMode();
+    }
 }
 
-void Timer::onTimeout()
+const SessionSchedule& Timer::getSchedule() const
 {
-    if (m_state != TimerState::Running)
+    return m_schedule;
+}
+
+void Timer::setTickConsumerVisible(bool visible)
+{
+    if (m_tickConsumerVisible == visible)
     {
         return;
     }
-    m_remainingSeconds--;
-    m_elapsedSeconds++;
 
-    emit timerTick(m_remainingSeconds);
+    m_tickConsumerVisible = visible;
 
-    if (m_remainingSeconds <= 0)
+    if (m_state == TimerState::Running)
     {
-        m_timer->stop();
-        m_state = TimerState::Stopped;
+        // Re-arm: either back to per-second ticks or a single completion deadline
+        scheduleWakeup();
+    }
 
-        emit timerTick(m_remainingSeconds);
+    if (m_tickConsumerVisible)
+    {
+        // Catch the display up with whatever happened while it was hidden
+        emit timerTick(getRemainingTime());
+    }
+}
 
-        if (m_remainingSeconds <= 0)
-        {
-            // Timer is complete
-            TimerMode completedMode = m_mode;
+bool Timer::isTickConsumerVisible() const
+{
+    return m_tickConsumerVisible;
+}
 
-            if (m_mode == TimerMode::Work)
-            {
-                m_pomodorosCompleted++;
-                emit pomodorosCompletedChanged(m_pomodorosCompleted);
-            }
+TimerSnapshot Timer::snapshot() const
+{
+    TimerSnapshot snapshot;
+    snapshot.mode = static_cast<quint8>(m_mode);
+    snapshot.state = static_cast<quint8>(m_state);
+    snapshot.stepIndex = static_cast<quint8>(m_stepIndex);
+    snapshot.pomodorosCompleted = m_pomodorosCompleted;
+    snapshot.remainingMs = remainingMs();
 
-            // Emit signal that the timer has completed with the mode that was completed
-            emit timerCompleted(completedMode);
+    if (m_state == TimerState::Running)
+    {
+        // Monotonic time does not survive a restart, wall-clock time does
+        snapshot.deadlineEpochMs = m_clock->currentDateTime().toMSecsSinceEpoch() + snapshot.remainingMs;
+    }
 
-            // Switch to the next mode
-            switchToNextMode();
-        }
+    return snapshot;
+}
+
+bool Timer::restore(const TimerSnapshot& snapshot)
+{
+    if (snapshot.mode > static_cast<quint8>(TimerMode::LongBreak) ||
+        snapshot.state > static_cast<quint8>(TimerState::Paused))
+    {
+        return false;
+    }
+
+    cancelWakeup();
+
+    TimerMode mode = static_cast<TimerMode>(snapshot.mode);
+    m_stepIndex = snapshot.stepIndex;
+    if (m_stepIndex >= m_schedule.size() || m_schedule.step(m_stepIndex).mode != mode)
+    {
+        // The plan changed since the snapshot was taken
+        m_stepIndex = m_schedule.firstStepWithMode(mode);
+    }
+    m_mode = m_schedule.step(m_stepIndex).mode;
+    m_sessionDuration = durationForStep(m_stepIndex);
+    m_pomodorosCompleted = qMax(0, snapshot.pomodorosCompleted);
+    m_state = static_cast<TimerState>(snapshot.state);
+
+    if (m_state == TimerState::Running)
+    {
+        // Whatever ran out while we were gone completes on the first wakeup
+        qint64 nowEpochMs = m_clock->currentDateTime().toMSecsSinceEpoch();
+        m_remainingMs = qMax<qint64>(0, snapshot.deadlineEpochMs - nowEpochMs);
+        armDeadline();
+        scheduleWakeup();
     }
+    else
+    {
+        m_remainingMs = qBound<qint64>(0, snapshot.remainingMs, m_sessionDuration * 1000LL);
+    }
+
+    emit modeChanged(m_mode);
+    emit pomodorosCompletedChanged(m_pomodorosCompleted);
+    emit stateChanged(m_state);
+    emit timerTick(getRemainingTime());
+    return true;
 }
 
-void Timer::switchToNextMode()
+void Timer::setClock(Clock* clock)
 {
-    TimerMode previousMode = m_mode;
+    if (!clock || clock == m_clock)
+    {
+        return;
+    }
+
+    // Carry a running session over to the new time base
+    qint64 remaining = remainingMs();
+    cancelWakeup();
+
+    m_clock = clock;
+    m_wakeupWindowStartMs = m_clock->monotonicMs();
 
-    switch (m_mode)
+    if (m_state == TimerState::Running)
     {
-    case TimerMode::Work:
-        // Check if it's time for a long break
-        if (m_pomodorosCompleted % m_longBreakInterval == 0)
-        {
-            m_mode = TimerMode::LongBreak;
-        }
-        else
+        m_deadlineMs = m_clock->monotonicMs() + remaining;
+        scheduleWakeup();
+    }
+}
+
+Clock* Timer::getClock() const
+{
+    return m_clock;
+}
+
+quint64 Timer::getWakeupCount() const
+{
+    return m_wakeupCount;
+}
+
+double Timer::getWakeupsPerMinute() const
+{
+    qint64 windowMs = m_clock->monotonicMs() - m_wakeupWindowStartMs;
+    if (windowMs <= 0)
+    {
+        return 0.0;
+    }
+
+    return m_wakeupCount * 60000.0 / windowMs;
+}
+
+void Timer::resetWakeupStats()
+{
+    m_wakeupCount = 0;
+    m_wakeupWindowStartMs = m_clock->monotonicMs();
+}
+
+void Timer::onTimeout()
+{
+    ZP_TRACE_SCOPE("timer", "Timer::tick");
+
+    m_wakeupCount++;
+
+    if (m_state != TimerState::Running)
+    {
+        return;
+    }
+
+    if (remainingMs() > 0)
+    {
+        if (m_tickConsumerVisible)
         {
-            m_mode = TimerMode::ShortBreak;
+            emit timerTick(getRemainingTime());
         }
-        break;
+        scheduleWakeup();
+        return;
+    }
 
-    case TimerMode::ShortBreak:
-    case TimerMode::LongBreak:
-        m_mode = TimerMode::Work;
-        break;
+    // Timer is complete
+    // Session recording runs inside this scope; notifications and restyle run
+    // later on the UI thread, via TickChannel
+    ZP_TRACE_SCOPE("timer", "Timer::complete");
+    cancelWakeup();
+    m_state = TimerState::Stopped;
+    m_remainingMs = 0;
+
+    emit timerTick(0);
+
+    TimerMode completedMode = m_mode;
+
+    if (m_mode == TimerMode::Work)
+    {
+        m_pomodorosCompleted++;
+        emit pomodorosCompletedChanged(m_pomodorosCompleted);
     }
 
+    // Emit signal that the timer has completed with the mode that was completed
+    emit timerCompleted(completedMode);
+
+    // Switch to the next mode
+    switchToNextMode();
+}
+
+void Timer::switchToNextMode()
+{
+    TimerMode previousMode = m_mode;
+
+    // Follow the transition table
+    m_stepIndex = m_schedule.next(m_stepIndex);
+    m_mode = m_schedule.step(m_stepIndex).mode;
+
     resetTimerForCurrentMode();
 
     if (previousMode != m_mode)
@@ -204,23 +375,112 @@ void Timer::switchToNextMode()
 
 void Timer::resetTimerForCurrentMode()
 {
-    switch (m_mode)
+    m_sessionDuration = durationForStep(m_stepIndex);
+    m_remainingMs = m_sessionDuration * 1000LL;
+    emit timerTick(m_sessionDuration);
+}
+
+int Timer::durationForStep(int index) const
+{
+    const ScheduleStep& step = m_schedule.step(index);
+    if (step.minutes > 0)
     {
-    case TimerMode::Work:
-        m_remainingSeconds = m_workDuration;
-        break;
+        return step.minutes * 60;
+    }
 
+    switch (step.mode)
+    {
     case TimerMode::ShortBreak:
-        m_remainingSeconds = m_shortBreakDuration;
-        break;
-
+        return m_shortBreakDuration;
     case TimerMode::LongBreak:
-        m_remainingSeconds = m_longBreakDuration;
-        break;
+        return m_longBreakDuration;
+    case TimerMode::Work:
+    default:
+        return m_workDuration;
     }
+}
 
-    m_elapsedSeconds = 0;
-    emit timerTick(m_remainingSeconds);
+void Timer::armDeadline()
+{
+    m_deadlineMs = m_clock->monotonicMs() + m_remainingMs;
+}
+
+void Timer::scheduleWakeup()
+{
+    qint64 remaining = remainingMs();
+
+    if (!m_tickConsumerVisible)
+    {
+        // Nobody is watching: sleep straight through to completion
+        armWakeup(remaining, Qt::PreciseTimer);
+        return;
+    }
+
+    // Wake up when the displayed second changes next
+    int displayed = secondsFromMs(remaining);
+    qint64 untilBoundary = remaining - (displayed - 1) * 1000LL;
+
+    if (displayed <= 1)
+    {
+        // The next boundary is the completion deadline itself
+        armWakeup(remaining, Qt::PreciseTimer);
+    }
+    else
+    {
+        // Intermediate ticks only refresh the display and may be coalesced
+        armWakeup(untilBoundary, Qt::CoarseTimer);
+    }
+}
+
+void Timer::armWakeup(qint64 msecs, Qt::TimerType type)
+{
+    msecs = qMax<qint64>(msecs, 0);
+
+    if (m_clock->isSimulated())
+    {
+        auto* clock = static_cast<SimulatedClock*>(m_clock);
+        clock->cancelWakeup(m_simulatedWakeup);
+        m_simulatedWakeup = clock->scheduleWakeup(clock->monotonicMs() + msecs, [this]()
+        {
+            m_simulatedWakeup = 0;
+            onTimeout();
+        });
+        return;
+    }
+
+    m_timer->setTimerType(type);
+    m_timer->start(static_cast<int>(msecs));
+}
+
+void Timer::cancelWakeup()
+{
+    m_timer->stop();
+
+    if (m_simulatedWakeup != 0 && m_clock->isSimulated())
+    {
+        static_cast<SimulatedClock*>(m_clock)->cancelWakeup(m_simulatedWakeup);
+    }
+    m_simulatedWakeup = 0;
+}
+
+qint64 Timer::remainingMs() const
+{
+    if (m_state == TimerState::Running)
+    {
+        return qMax<qint64>(0, m_deadlineMs - m_clock->monotonicMs());
+    }
+
+    return m_remainingMs;
+}
+
+int Timer::secondsFromMs(qint64 ms)
+{
+    if (ms <= 0)
+    {
+        return 0;
+    }
+
+    return static_cast<int>((ms + 999 - kTickSlackMs) / 1000);
 }
 
 
@@ -229,24 +489,29 @@ void Timer::skipBreak()
     // Only skip if we're in a break mode
     if (m_mode == TimerMode::ShortBreak || m_mode == TimerMode::LongBreak)
     {
-        // Reset the timer
-        m_remainingSeconds = m_workDuration;
-        m_elapsedSeconds = 0;
+        TimerMode skippedMode = m_mode;
+
+        // Reset the timer to the next work step of the plan
+        m_stepIndex = m_schedule.nextWorkStep(m_stepIndex);
+        m_sessionDuration = durationForStep(m_stepIndex);
+        m_remainingMs = m_sessionDuration * 1000LL;
 
         // Switch to work mode
         m_mode = TimerMode::Work;
 
-        // Emit signals
-        emit modeChanged(m_mode);
-        emit timerTick(m_remainingSeconds);
-
-        // Auto-start the new work session if the break was running
+        // Keep a running timer running, just against the new work deadline
         if (m_state == TimerState::Running)
         {
-            // No need to call start() since we just want to continue with the timer running
-            // The timer is already running, we just changed the mode and duration
+            armDeadline();
+            scheduleWakeup();
         }
-        else
+
+        // Emit signals
+        emit sessionSkipped(skippedMode);
+        emit modeChanged(m_mode);
+        emit timerTick(getRemainingTime());
+
+        if (m_state != TimerState::Running)
         {
             // If the timer was paused or stopped, keep it in that state
             reset();
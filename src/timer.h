@@ -8,6 +8,10 @@
 #include <QObject>
 #include <QTimer>
 
+#include "clock.h"
+#include "sessionschedule.h"
+#include "sessionsnapshot.h"
+
 class Timer : public QObject
 {
     Q_OBJECT
@@ -20,12 +24,7 @@ public:
         Paused
     };
 
-    enum class TimerMode
-    {
-        Work,
-        ShortBreak,
-        LongBreak
-    };
+    using TimerMode = SessionMode;
 
     explicit Timer(QObject* parent = nullptr);
     ~Timer() override;
@@ -40,16 +39,40 @@ public:
     TimerMode getMode() const;
     int getRemainingTime() const;
     int getElapsedTime() const;
+    int getSessionDuration() const; // Full length of the current session in seconds
     int getTotalCompletedPomodoros() const;
 
     void setWorkDuration(int minutes);
     void setShortBreakDuration(int minutes);
     void setLongBreakDuration(int minutes);
-    void setLongBreakInterval(int count);
+
+    // Replaces the session plan; the cycle position is kept on the current mode
+    void setSchedule(const SessionSchedule& schedule);
+    const SessionSchedule& getSchedule() const;
+
+    // Adaptive ticking: without a visible consumer only the completion
+    // deadline is armed, otherwise ticks are aligned to second boundaries
+    void setTickConsumerVisible(bool visible);
+    bool isTickConsumerVisible() const;
+
+    // Capture and restore the complete engine state (see SessionSnapshotStore)
+    TimerSnapshot snapshot() const;
+    bool restore(const TimerSnapshot& snapshot);
+
+    // Time source; defaults to Clock::instance(). A simulated clock drives
+    // wakeups itself instead of the internal QTimer.
+    void setClock(Clock* clock);
+    Clock* getClock() const;
+
+    // Wakeup accounting, used to verify the savings of adaptive ticking
+    quint64 getWakeupCount() const;
+    double getWakeupsPerMinute() const;
+    void resetWakeupStats();
 
 signals:
     void timerTick(int remainingSeconds);
     void timerCompleted(TimerMode completedMode);
+    void sessionSkipped(TimerMode skippedMode); // Emitted once the timer has moved past the skipped session
     void modeChanged(TimerMode newMode);
     void stateChanged(TimerState newState);
     void pomodorosCompletedChanged(int count);
@@ -59,18 +82,34 @@ private slots:
 
 private:
     QTimer* m_timer;
+    Clock* m_clock;
+    SimulatedClock::WakeupId m_simulatedWakeup;
     TimerState m_state;
     TimerMode m_mode;
-    int m_remainingSeconds;
-    int m_elapsedSeconds;
+    qint64 m_deadlineMs; // Clock time of completion, valid while running
+    qint64 m_remainingMs; // Valid while stopped or paused
+    int m_sessionDuration; // Length of the current session in seconds
     int m_workDuration;
     int m_shortBreakDuration;
     int m_longBreakDuration;
-    int m_longBreakInterval;
     int m_pomodorosCompleted;
 
+    SessionSchedule m_schedule;
+    int m_stepIndex; // Current row of the schedule's transition table
+
+    bool m_tickConsumerVisible;
+    quint64 m_wakeupCount;
+    qint64 m_wakeupWindowStartMs;
+
     void switchToNextMode();
     void resetTimerForCurrentMode();
+    int durationForStep(int index) const;
+    void armDeadline();
+    void scheduleWakeup();
+    void armWakeup(qint64 msecs, Qt::TimerType type);
+    void cancelWakeup();
+    qint64 remainingMs() const;
+    static int secondsFromMs(qint64 ms);
 };
 
 #endif // ZIGA_POMODORO_TIMER_H
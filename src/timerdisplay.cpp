@@ -0,0 +1,350 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "timerdisplay.h"
+#include "trace.h"
+#include "paintprofiler.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QFontInfo>
+#include <QFontMetricsF>
+#include <QGraphicsScene>
+#include <QGraphicsPixmapItem>
+#include <QGraphicsDropShadowEffect>
+#include <QtMath>
+
+TimerDisplay::TimerDisplay(QWidget* parent)
+    : QWidget(parent)
+      , m_seconds(-1)
+      , m_textColor(Qt::white)
+      , m_backgroundColor(Qt::transparent)
+      , m_shadowEnabled(false)
+      , m_shadowBlur(0)
+      , m_atlasValid(false)
+      , m_atlasDpr(1.0)
+      , m_margin(0)
+      , m_deviceSlotWidth(0)
+      , m_glyphAdvance{}
+      , m_atlasBuilds(0)
+{
+    setAttribute(Qt::WA_NoSystemBackground);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+    m_font = font();
+    setSeconds(0);
+}
+
+TimerDisplay::~TimerDisplay() = default;
+
+void TimerDisplay::setSeconds(int seconds)
+{
+    seconds = qMax(0, seconds);
+    if (seconds == m_seconds)
+    {
+        return;
+    }
+    m_seconds = seconds;
+
+    QVector<quint8> glyphs = glyphsFor(seconds);
+    if (glyphs.size() != m_glyphs.size() || !m_atlasValid)
+    {
+        // Another minute digit moves every cell, and without an atlas there is
+        // no layout yet; either way the next paint redraws everything
+        bool resized = glyphs.size() != m_glyphs.size();
+        m_glyphs = glyphs;
+        if (m_atlasValid)
+        {
+            layoutCells();
+        }
+        if (resized)
+        {
+            updateGeometry();
+        }
+        update();
+        return;
+    }
+
+    // Digit cells share one width, so only the cells whose glyph changed are invalidated
+    for (int i = 0; i < glyphs.size(); i++)
+    {
+        if (glyphs[i] != m_glyphs[i])
+        {
+            m_glyphs[i] = glyphs[i];
+            update(cellRect(i));
+        }
+    }
+}
+
+int TimerDisplay::seconds() const
+{
+    return m_seconds;
+}
+
+void TimerDisplay::setDisplayFont(const QFont& font)
+{
+    if (font == m_font)
+    {
+        return;
+    }
+    m_font = font;
+    invalidateAtlas();
+}
+
+void TimerDisplay::setTextColor(const QColor& color)
+{
+    if (color == m_textColor)
+    {
+        return;
+    }
+    m_textColor = color;
+    invalidateAtlas();
+}
+
+void TimerDisplay::setBackgroundColor(const QColor& color)
+{
+    if (color == m_backgroundColor)
+    {
+        return;
+    }
+    m_backgroundColor = color;
+    update();
+}
+
+void TimerDisplay::setShadow(bool enabled, const QPointF& offset, qreal blurRadius, const QColor& color)
+{
+    if (enabled == m_shadowEnabled &&
+        (!enabled || (offset == m_shadowOffset && qFuzzyCompare(blurRadius + 1, m_shadowBlur + 1) &&
+            color == m_shadowColor)))
+    {
+        return;
+    }
+    m_shadowEnabled = enabled;
+    m_shadowOffset = offset;
+    m_shadowBlur = blurRadius;
+    m_shadowColor = color;
+    invalidateAtlas();
+}
+
+int TimerDisplay::atlasBuildCount() const
+{
+    return m_atlasBuilds;
+}
+
+void TimerDisplay::setPaintStats(PaintStats* stats)
+{
+    m_paintStats = stats;
+}
+
+QRect TimerDisplay::contentRect() const
+{
+    return m_contentRect;
+}
+
+QSize TimerDisplay::sizeHint() const
+{
+    const_cast<TimerDisplay*>(this)->ensureAtlas();
+
+    int width = 2 * m_margin;
+    for (quint8 glyph : m_glyphs)
+    {
+        width += m_glyphAdvance[glyph];
+    }
+    return QSize(width, m_slotSize.height());
+}
+
+QSize TimerDisplay::minimumSizeHint() const
+{
+    return sizeHint();
+}
+
+void TimerDisplay::paintEvent(QPaintEvent* event)
+{
+    ZP_TRACE_SCOPE("paint", "TimerDisplay::paintEvent");
+
+    PaintScope profile(m_paintStats, event->region());
+    ensureAtlas();
+
+    QPainter painter(this);
+
+    if (m_backgroundColor.alpha() > 0)
+    {
+        painter.fillRect(event->rect(), m_backgroundColor);
+    }
+
+    // Neighbouring shadows overlap, so every cell touching the dirty area is drawn
+    for (int i = 0; i < m_glyphs.size(); i++)
+    {
+        QRect target = cellRect(i);
+        if (!event->region().intersects(target))
+        {
+            continue;
+        }
+        // Source rectangles are in device pixels of the atlas
+        QRectF source(m_glyphs[i] * m_deviceSlotWidth, 0, target.width() * m_atlasDpr, target.height() * m_atlasDpr);
+        painter.drawPixmap(QPointF(target.topLeft()), m_atlas, source);
+    }
+}
+
+void TimerDisplay::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    if (m_atlasValid)
+    {
+        layoutCells();
+    }
+}
+
+void TimerDisplay::invalidateAtlas()
+{
+    // Rebuilt lazily, so several setters in a row cost one rebuild
+    m_atlasValid = false;
+    updateGeometry();
+    update();
+}
+
+void TimerDisplay::ensureAtlas()
+{
+    qreal dpr = devicePixelRatioF();
+    if (m_atlasValid && qFuzzyCompare(dpr, m_atlasDpr))
+    {
+        return;
+    }
+    m_atlasValid = true;
+    m_atlasDpr = dpr;
+    m_atlasBuilds++;
+
+    // Everything below is in device pixels; the pixmap gets the ratio at the end
+    QFont deviceFont = m_font;
+    deviceFont.setPixelSize(qMax(1, qRound(QFontInfo(m_font).pixelSize() * dpr)));
+    QFontMetricsF metrics(deviceFont);
+
+    const QString glyphText = QStringLiteral("0123456789:");
+    qreal advances[GlyphCount];
+    qreal digitAdvance = 0;
+    for (int i = 0; i < GlyphCount; i++)
+    {
+        advances[i] = metrics.horizontalAdvance(glyphText.at(i));
+        if (i != ColonGlyph)
+        {
+            digitAdvance = qMax(digitAdvance, advances[i]);
+        }
+    }
+
+    // Every digit gets the widest digit's cell, so swapping one digit for
+    // another never moves its neighbours, even with proportional figures
+    qreal maxAdvance = qMax(digitAdvance, advances[ColonGlyph]);
+    for (int i = 0; i < GlyphCount; i++)
+    {
+        m_glyphAdvance[i] = qCeil((i == ColonGlyph ? advances[i] : digitAdvance) / dpr);
+    }
+
+    qreal shadowReach = m_shadowEnabled
+                            ? m_shadowBlur + qMax(qAbs(m_shadowOffset.x()), qAbs(m_shadowOffset.y()))
+                            : 0;
+    m_margin = qCeil(shadowReach) + 1;
+
+    int deviceMargin = qCeil(m_margin * dpr);
+    int slotWidth = qCeil(maxAdvance) + 2 * deviceMargin;
+    int slotHeight = qCeil(metrics.height()) + 2 * deviceMargin;
+
+    QImage glyphs(slotWidth * GlyphCount, slotHeight, QImage::Format_ARGB32_Premultiplied);
+    glyphs.fill(Qt::transparent);
+    {
+        QPainter painter(&glyphs);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.setFont(deviceFont);
+        painter.setPen(m_textColor);
+        for (int i = 0; i < GlyphCount; i++)
+        {
+            // Narrow digits are centred in their cell
+            qreal inset = i == ColonGlyph ? 0 : (digitAdvance - advances[i]) / 2;
+            painter.drawText(QPointF(i * slotWidth + deviceMargin + inset, deviceMargin + metrics.ascent()),
+                             glyphText.at(i));
+        }
+    }
+
+    if (m_shadowEnabled)
+    {
+        // One blur pass over the whole strip, done offscreen
+        QGraphicsScene scene;
+        QGraphicsPixmapItem* item = scene.addPixmap(QPixmap::fromImage(glyphs));
+        auto shadow = new QGraphicsDropShadowEffect();
+        shadow->setOffset(m_shadowOffset * dpr);
+        shadow->setBlurRadius(m_shadowBlur * dpr);
+        shadow->setColor(m_shadowColor);
+        item->setGraphicsEffect(shadow); // Owned by the item
+
+        QImage shadowed(glyphs.size(), QImage::Format_ARGB32_Premultiplied);
+        shadowed.fill(Qt::transparent);
+        QPainter painter(&shadowed);
+        scene.render(&painter, QRectF(shadowed.rect()), QRectF(shadowed.rect()));
+        painter.end();
+        glyphs = shadowed;
+    }
+
+    m_atlas = QPixmap::fromImage(glyphs);
+    m_atlas.setDevicePixelRatio(dpr);
+    m_deviceSlotWidth = slotWidth;
+    m_slotSize = QSize(qCeil(slotWidth / dpr), qCeil(slotHeight / dpr));
+
+    layoutCells();
+}
+
+void TimerDisplay::layoutCells()
+{
+    int contentWidth = 0;
+    for (quint8 glyph : m_glyphs)
+    {
+        contentWidth += m_glyphAdvance[glyph];
+    }
+
+    // Centred like the label it replaces
+    m_origin = QPoint((width() - contentWidth) / 2 - m_margin, (height() - m_slotSize.height()) / 2);
+
+    m_cellX.resize(m_glyphs.size());
+    int x = m_origin.x();
+    for (int i = 0; i < m_glyphs.size(); i++)
+    {
+        m_cellX[i] = x;
+        x += m_glyphAdvance[m_glyphs[i]];
+    }
+
+    QRect content(m_origin, QSize(contentWidth + 2 * m_margin, m_slotSize.height()));
+    if (content != m_contentRect)
+    {
+        m_contentRect = content;
+        emit contentRectChanged(m_contentRect);
+    }
+}
+
+QRect TimerDisplay::cellRect(int index) const
+{
+    return QRect(m_cellX[index], m_origin.y(),
+                 m_glyphAdvance[m_glyphs[index]] + 2 * m_margin, m_slotSize.height());
+}
+
+QVector<quint8> TimerDisplay::glyphsFor(int seconds)
+{
+    QVector<quint8> glyphs;
+    int minutes = seconds / 60;
+    int secs = seconds % 60;
+
+    // At least two minute digits, like "05:00"
+    QVector<quint8> minuteDigits;
+    do
+    {
+        minuteDigits.prepend(static_cast<quint8>(minutes % 10));
+        minutes /= 10;
+    }
+    while (minutes > 0);
+    if (minuteDigits.size() < 2)
+    {
+        minuteDigits.prepend(0);
+    }
+
+    glyphs = minuteDigits;
+    glyphs.append(ColonGlyph);
+    glyphs.append(static_cast<quint8>(secs / 10));
+    glyphs.append(static_cast<quint8>(secs % 10));
+    return glyphs;
+}
@@ -0,0 +1,88 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_TIMERDISPLAY_H
+#define ZIGA_POMODORO_TIMERDISPLAY_H
+
+#include <QWidget>
+#include <QPixmap>
+#include <QVector>
+
+class PaintStats;
+
+// Countdown display painted from a glyph atlas. The digits 0-9 and the colon
+// are rendered once, shadow included, and each tick only repaints the cells
+// whose glyph changed. The atlas is rebuilt only when the font, colour,
+// shadow or device pixel ratio changes.
+class TimerDisplay : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TimerDisplay(QWidget* parent = nullptr);
+    ~TimerDisplay() override;
+
+    void setSeconds(int seconds);
+    int seconds() const;
+
+    void setDisplayFont(const QFont& font);
+    void setTextColor(const QColor& color);
+    void setBackgroundColor(const QColor& color); // Transparent for none
+    void setShadow(bool enabled, const QPointF& offset = QPointF(), qreal blurRadius = 0,
+                   const QColor& color = QColor());
+
+    int atlasBuildCount() const; // How often the atlas was rendered
+    void setPaintStats(PaintStats* stats); // Null turns profiling off
+
+    // Area covered by the cells including shadow margins; changes only with the layout
+    QRect contentRect() const;
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+signals:
+    void contentRectChanged(const QRect& rect);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private:
+    static constexpr int GlyphCount = 11; // 0-9 and ':'
+    static constexpr int ColonGlyph = 10;
+
+    void invalidateAtlas();
+    void ensureAtlas();
+    void layoutCells(); // Needs a valid atlas
+    QRect cellRect(int index) const; // Includes the shadow margin
+    static QVector<quint8> glyphsFor(int seconds);
+
+    int m_seconds;
+    QVector<quint8> m_glyphs; // Glyph index per cell
+    QVector<int> m_cellX; // Left edge of each cell, logical pixels
+
+    // Appearance
+    QFont m_font;
+    QColor m_textColor;
+    QColor m_backgroundColor;
+    bool m_shadowEnabled;
+    QPointF m_shadowOffset;
+    qreal m_shadowBlur;
+    QColor m_shadowColor;
+
+    // Atlas, in logical pixels; slots are m_slotSize apart
+    QPixmap m_atlas;
+    bool m_atlasValid;
+    qreal m_atlasDpr;
+    int m_margin; // Room for the shadow around each glyph
+    int m_deviceSlotWidth; // Slot pitch inside the atlas, device pixels
+    QSize m_slotSize;
+    int m_glyphAdvance[GlyphCount];
+    QPoint m_origin; // Top-left of the first cell inside the widget
+    QRect m_contentRect;
+    int m_atlasBuilds;
+    PaintStats* m_paintStats = nullptr;
+};
+
+#endif // ZIGA_POMODORO_TIMERDISPLAY_H
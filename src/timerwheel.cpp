@@ -0,0 +1,199 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "timerwheel.h"
+
+TimerWheel::TimerWheel(qint64 startTick)
+    : m_currentTick(startTick)
+      , m_size(0)
+{
+    m_heads.fill(NoEntry);
+    m_levelCounts.fill(0);
+}
+
+TimerWheel::Handle TimerWheel::arm(qint64 expiryTick, quint32 payload)
+{
+    quint32 index;
+    if (!m_freeList.empty())
+    {
+        index = m_freeList.back();
+        m_freeList.pop_back();
+    }
+    else
+    {
+        index = static_cast<quint32>(m_entries.size());
+        m_entries.push_back(Entry{0, 0, NoEntry, NoEntry, 0, 0, false});
+    }
+
+    Entry& entry = m_entries[index];
+    entry.expiry = qMax(expiryTick, m_currentTick + 1); // Never fire in the past
+    entry.payload = payload;
+    entry.armed = true;
+    link(index);
+    m_size++;
+
+    return (Handle(entry.generation) << 32) | (index + 1);
+}
+
+bool TimerWheel::cancel(Handle handle)
+{
+    quint32 index = indexOf(handle);
+    if (index == NoEntry)
+    {
+        return false;
+    }
+
+    unlink(index);
+    release(index);
+    return true;
+}
+
+qint64 TimerWheel::nextEventTick() const
+{
+    if (m_size == 0)
+    {
+        return -1;
+    }
+
+    // Coarser entries first come down at the next boundary of their level;
+    // the nearest boundary of any occupied level bounds them all
+    qint64 next = -1;
+    for (int level = Levels - 1; level >= 1; level--)
+    {
+        if (m_levelCounts[level] > 0)
+        {
+            int shift = level * LevelBits;
+            next = ((m_currentTick >> shift) + 1) << shift;
+        }
+    }
+
+    // Finest level entries expire within one revolution, in slot order
+    if (m_levelCounts[0] > 0)
+    {
+        for (qint64 tick = m_currentTick + 1; tick <= m_currentTick + SlotsPerLevel; tick++)
+        {
+            if (next >= 0 && tick >= next)
+            {
+                break;
+            }
+            if (m_heads[tick & SlotMask] != NoEntry)
+            {
+                return tick;
+            }
+        }
+    }
+
+    return next;
+}
+
+bool TimerWheel::isArmed(Handle handle) const
+{
+    return indexOf(handle) != NoEntry;
+}
+
+int TimerWheel::slotFor(qint64 expiry) const
+{
+    qint64 delta = expiry - m_currentTick;
+
+    for (int level = 0; level < Levels; level++)
+    {
+        if (delta < (qint64(1) << ((level + 1) * LevelBits)))
+        {
+            return level * SlotsPerLevel + static_cast<int>((expiry >> (level * LevelBits)) & SlotMask);
+        }
+    }
+
+    // Beyond the wheel's range: park in the farthest slot and re-slot on cascade
+    qint64 parked = m_currentTick + (qint64(1) << (Levels * LevelBits)) - 1;
+    return (Levels - 1) * SlotsPerLevel + static_cast<int>((parked >> ((Levels - 1) * LevelBits)) & SlotMask);
+}
+
+void TimerWheel::link(quint32 index)
+{
+    Entry& entry = m_entries[index];
+    int slot = slotFor(entry.expiry);
+
+    entry.slot = static_cast<quint16>(slot);
+    entry.prev = NoEntry;
+    entry.next = m_heads[slot];
+    if (entry.next != NoEntry)
+    {
+        m_entries[entry.next].prev = index;
+    }
+    m_heads[slot] = index;
+    m_levelCounts[slot / SlotsPerLevel]++;
+}
+
+void TimerWheel::unlink(quint32 index)
+{
+    Entry& entry = m_entries[index];
+
+    if (entry.prev != NoEntry)
+    {
+        m_entries[entry.prev].next = entry.next;
+    }
+    else
+    {
+        m_heads[entry.slot] = entry.next;
+    }
+
+    if (entry.next != NoEntry)
+    {
+        m_entries[entry.next].prev = entry.prev;
+    }
+
+    entry.prev = NoEntry;
+    entry.next = NoEntry;
+    m_levelCounts[entry.slot / SlotsPerLevel]--;
+}
+
+void TimerWheel::release(quint32 index)
+{
+    Entry& entry = m_entries[index];
+    entry.armed = false;
+    entry.generation++; // Invalidates outstanding handles
+    m_freeList.push_back(index);
+    m_size--;
+}
+
+void TimerWheel::cascade(int level)
+{
+    int slot = level * SlotsPerLevel + static_cast<int>((m_currentTick >> (level * LevelBits)) & SlotMask);
+
+    // Detach the whole slot, then re-link every entry relative to the new time
+    quint32 index = m_heads[slot];
+    m_heads[slot] = NoEntry;
+
+    while (index != NoEntry)
+    {
+        quint32 next = m_entries[index].next;
+        m_levelCounts[level]--;
+        link(index);
+        index = next;
+    }
+}
+
+quint32 TimerWheel::indexOf(Handle handle) const
+{
+    if (handle == InvalidHandle)
+    {
+        return NoEntry;
+    }
+
+    quint32 index = static_cast<quint32>(handle & 0xFFFFFFFFu) - 1;
+    quint32 generation = static_cast<quint32>(handle >> 32);
+
+    if (index >= m_entries.size())
+    {
+        return NoEntry;
+    }
+
+    const Entry& entry = m_entries[index];
+    if (!entry.armed || entry.generation != generation)
+    {
+        return NoEntry;
+    }
+
+    return index;
+}
@@ -0,0 +1,134 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_TIMERWHEEL_H
+#define ZIGA_POMODORO_TIMERWHEEL_H
+
+#include <QtGlobal>
+#include <array>
+#include <vector>
+
+// Hierarchical timing wheel: four levels of 256 slots, O(1) arm and cancel.
+// Time is measured in abstract ticks; the owner decides the tick length.
+class TimerWheel
+{
+public:
+    using Handle = quint64;
+    static constexpr Handle InvalidHandle = 0;
+
+    explicit TimerWheel(qint64 startTick = 0);
+
+    // Arms an entry that fires once `currentTick()` reaches `expiryTick`
+    Handle arm(qint64 expiryTick, quint32 payload);
+    bool cancel(Handle handle);
+    bool isArmed(Handle handle) const;
+
+    // Moves time forward to `nowTick`, calling onExpired(payload) for every
+    // entry that expires on the way. Callbacks may arm and cancel entries.
+    template <typename Callback>
+    void advance(qint64 nowTick, Callback&& onExpired);
+
+    // Earliest tick at which advance() may have work to do (an expiry or a
+    // cascade), -1 when nothing is armed
+    qint64 nextEventTick() const;
+
+    qint64 currentTick() const { return m_currentTick; }
+    int size() const { return m_size; }
+
+private:
+    static constexpr int LevelBits = 8;
+    static constexpr int SlotsPerLevel = 1 << LevelBits;
+    static constexpr int SlotMask = SlotsPerLevel - 1;
+    static constexpr int Levels = 4;
+    static constexpr quint32 NoEntry = 0xFFFFFFFFu;
+
+    struct Entry
+    {
+        qint64 expiry;
+        quint32 payload;
+        quint32 prev;
+        quint32 next;
+        quint32 generation;
+        quint16 slot; // Index into m_heads while armed
+        bool armed;
+    };
+
+    std::vector<Entry> m_entries;
+    std::vector<quint32> m_freeList;
+    std::array<quint32, Levels * SlotsPerLevel> m_heads;
+    std::array<int, Levels> m_levelCounts;
+    qint64 m_currentTick;
+    int m_size;
+
+    int slotFor(qint64 expiry) const;
+    void link(quint32 index);
+    void unlink(quint32 index);
+    void release(quint32 index);
+    void cascade(int level);
+    quint32 indexOf(Handle handle) const;
+};
+
+template <typename Callback>
+void TimerWheel::advance(qint64 nowTick, Callback&& onExpired)
+{
+    while (m_currentTick < nowTick)
+    {
+        if (m_size == 0)
+        {
+            // Nothing armed, jump straight to the target
+            m_currentTick = nowTick;
+            return;
+        }
+
+        // With the finest levels empty nothing can happen before the next
+        // boundary of the first occupied level, so skip ahead to it
+        int emptyLevels = 0;
+        while (m_levelCounts[emptyLevels] == 0)
+        {
+            emptyLevels++;
+        }
+        if (emptyLevels > 0)
+        {
+            qint64 span = qint64(1) << (emptyLevels * LevelBits);
+            qint64 beforeBoundary = ((m_currentTick >> (emptyLevels * LevelBits)) + 1) * span - 1;
+            if (beforeBoundary > m_currentTick)
+            {
+                m_currentTick = qMin(beforeBoundary, nowTick);
+                continue;
+            }
+        }
+
+        m_currentTick++;
+
+        // Pull entries down from coarser levels whenever a finer level wraps
+        for (int level = 1; level < Levels; level++)
+        {
+            if ((m_currentTick & ((qint64(1) << (level * LevelBits)) - 1)) != 0)
+            {
+                break;
+            }
+            cascade(level);
+        }
+
+        int slot = static_cast<int>(m_currentTick & SlotMask);
+        while (m_heads[slot] != NoEntry)
+        {
+            quint32 index = m_heads[slot];
+            unlink(index);
+
+            if (m_entries[index].expiry > m_currentTick)
+            {
+                // Parked far ahead of the wheel's range, put it back
+                link(index);
+                continue;
+            }
+
+            quint32 payload = m_entries[index].payload;
+            release(index);
+            onExpired(payload);
+        }
+    }
+}
+
+#endif // ZIGA_POMODORO_TIMERWHEEL_H
@@ -3,47 +3,47 @@
 //
 
 #include "timerwindow.h"
+#include "trace.h"
 #include <QPainter>
 #include <QMouseEvent>
 #include <QApplication>
 #include <QStyle>
-#include <QGraphicsDropShadowEffect>
-#include <QMediaPlayer> // Make sure these are included at the top of timerwindow.cpp
 #include <QSystemTrayIcon>
+#include <QElapsedTimer>
+#include <QRegion>
+#include <QMenu>
+#include <QFileDialog>
 
-TimerWindow::TimerWindow(Settings* settings, QWidget* parent)
+TimerWindow::TimerWindow(Settings* settings, SessionController* controller, QWidget* parent)
     : QWidget(parent)
       , m_appSettings(settings)
-      , m_timer(new Timer(this))
+      , m_controller(controller)
+      , m_timer(controller->getTimer())
       , m_mainWindow(nullptr)
 {
     m_dbManager = nullptr;
     m_hasDbManager = false;
-    m_sessionStartTime = QDateTime();
 
 
     // Set window flags for a frameless, always-on-top window
     setWindowFlags(Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::Tool);
-    setAttribute(Qt::WA_TranslucentBackground);
+    m_shapeMasked = m_appSettings->getShapeMaskEnabled();
+    setAttribute(Qt::WA_TranslucentBackground, !m_shapeMasked);
 
     setupUi();
     setupConnections();
 
-    // Initialize timer with durations from settings - NOW USING m_appSettings
-    m_timer->setWorkDuration(m_appSettings->getWorkDuration()); // Convert minutes to seconds
-    m_timer->setShortBreakDuration(m_appSettings->getShortBreakDuration());
-    m_timer->setLongBreakDuration(m_appSettings->getLongBreakDuration());
-    m_timer->setLongBreakInterval(m_appSettings->getLongBreakInterval());
     // Initialize timer display
     updateTimerDisplay(m_timer->getRemainingTime());
     handleModeChanged(m_timer->getMode());
     handleStateChanged(m_timer->getState());
 
-    m_mediaPlayer = new QMediaPlayer(this);
     m_trayIcon = new QSystemTrayIcon(this);
     m_trayIcon->setIcon(QIcon::fromTheme("ziga-pomodoro-icon", QIcon(":/icons/tomato.png")));
     // Replace with your icon
     m_trayIcon->show(); // Show tray icon (or hide it if you only want notifications)
+
+    m_notifier = new SessionNotifier(m_controller, m_appSettings, m_trayIcon, this);
 }
 
 TimerWindow::~TimerWindow() = default;
@@ -56,18 +56,19 @@ void TimerWindow::setupUi()
     m_mainLayout->setSpacing(10);
     m_mainLayout->setContentsMargins(20, 20, 20, 20);
 
-    // Create timer display label
-    m_timerLabel = new QLabel("25:00", this);
-    QFont timerFont = m_timerLabel->font();
-    timerFont.setPointSize(m_appSettings->getFontSize());
-    timerFont.setBold(true);
-    m_timerLabel->setFont(timerFont);
-    m_timerLabel->setAlignment(Qt::AlignCenter);
+    // Create the progress ring first so it stays below everything else
+    m_progressRing = new ProgressRing(this);
+    m_progressRing->setVisible(m_appSettings->getProgressRingEnabled());
+    m_progressRing->lower();
+
+    // Create timer display, painted from a cached glyph atlas
+    m_timerDisplay = new TimerDisplay(this);
+    m_timerDisplay->setSeconds(25 * 60);
 
-    updateTimerLabelStyle(); // New method to update the label style
+    rebuildStyles();
+    applyStyle(m_timer->getMode());
 
-    // m_timerLabel->setStyleSheet("color: white;"); // Only color, no background
-    m_mainLayout->addWidget(m_timerLabel);
+    m_mainLayout->addWidget(m_timerDisplay);
 
     // Create button layout
     m_buttonLayout = new QHBoxLayout();
@@ -181,51 +182,172 @@ void TimerWindow::setupUi()
     resize(300, 150);
 }
 
-void TimerWindow::updateTimerLabelStyle()
+void TimerWindow::rebuildStyles()
 {
-    // Get font size
-    int fontSize = m_appSettings->getFontSize();
+    TimerStyle base;
+    base.font = m_timerDisplay->font();
+    base.font.setPointSize(m_appSettings->getFontSize());
+    base.font.setBold(true);
+    base.fontSize = m_appSettings->getFontSize();
+    base.textColor = QColor(m_appSettings->getFontColor());
+    base.backgroundColor = Qt::transparent;
+    base.shadowEnabled = m_appSettings->getTextShadowEnabled();
+    base.shadowOffset = QPointF(m_appSettings->getTextShadowOffsetX(), m_appSettings->getTextShadowOffsetY());
+    base.shadowBlur = m_appSettings->getTextShadowBlur();
+    base.shadowColor = QColor(m_appSettings->getTextShadowColor());
+
+    // Breaks only differ by their green background
+    TimerStyle breakStyle = base;
+    breakStyle.backgroundColor = QColor(46, 204, 113, 150);
+
+    m_styles[static_cast<int>(Timer::TimerMode::Work)] = base;
+    m_styles[static_cast<int>(Timer::TimerMode::ShortBreak)] = breakStyle;
+    m_styles[static_cast<int>(Timer::TimerMode::LongBreak)] = breakStyle;
+}
+
+void TimerWindow::applyStyle(Timer::TimerMode mode)
+{
+    ZP_TRACE_SCOPE("ui", "TimerWindow::applyStyle");
 
-    // Set font color
-    QString styleSheet = QString("color: %1;").arg(m_appSettings->getFontColor());
+    const TimerStyle& style = m_styles[static_cast<int>(mode)];
+    const TimerStyle& applied = m_appliedStyle;
+    bool changed = false;
 
-    // Apply background color for break modes
-    if (m_timer->getMode() == Timer::TimerMode::ShortBreak ||
-        m_timer->getMode() == Timer::TimerMode::LongBreak)
+    // Font, colour and shadow live in the display's glyph atlas
+    if (!m_hasAppliedStyle || style.font != applied.font)
     {
-        styleSheet += " background-color: rgba(46, 204, 113, 150);"; // Green background
+        m_timerDisplay->setDisplayFont(style.font);
+        changed = true;
+    }
+    if (!m_hasAppliedStyle || style.textColor != applied.textColor)
+    {
+        m_timerDisplay->setTextColor(style.textColor);
+
+        // The ring follows the text colour
+        QColor track = style.textColor;
+        track.setAlpha(40);
+        m_progressRing->setRingColor(style.textColor);
+        m_progressRing->setTrackColor(track);
+        changed = true;
+    }
+    if (!m_hasAppliedStyle || style.shadowEnabled != applied.shadowEnabled ||
+        style.shadowOffset != applied.shadowOffset || style.shadowBlur != applied.shadowBlur ||
+        style.shadowColor != applied.shadowColor)
+    {
+        m_timerDisplay->setShadow(style.shadowEnabled, style.shadowOffset, style.shadowBlur, style.shadowColor);
+        changed = true;
     }
 
-    m_timerLabel->setStyleSheet(styleSheet);
+    // The background is a plain fill, no re-render needed
+    if (!m_hasAppliedStyle || style.backgroundColor != applied.backgroundColor)
+    {
+        m_timerDisplay->setBackgroundColor(style.backgroundColor);
+        changed = true;
+    }
 
-    // Apply text shadow if enabled
-    if (m_appSettings->getTextShadowEnabled())
+    // The window size only depends on the font size
+    if (!m_hasAppliedStyle || style.fontSize != applied.fontSize)
     {
-        auto shadowEffect = new QGraphicsDropShadowEffect();
-        shadowEffect->setOffset(m_appSettings->getTextShadowOffsetX(),
-                                m_appSettings->getTextShadowOffsetY());
-        shadowEffect->setBlurRadius(m_appSettings->getTextShadowBlur());
-        shadowEffect->setColor(QColor(m_appSettings->getTextShadowColor()));
+        updateWindowSize();
+    }
 
-        m_timerLabel->setGraphicsEffect(shadowEffect);
+    if (changed)
+    {
+        m_restyleCount++;
     }
-    else
+    m_appliedStyle = style;
+    m_hasAppliedStyle = true;
+}
+
+int TimerWindow::getRestyleCount() const
+{
+    return m_restyleCount;
+}
+
+int TimerWindow::getMaskUpdateCount() const
+{
+    return m_maskUpdateCount;
+}
+
+qint64 TimerWindow::getMaskUpdateMicros() const
+{
+    return m_maskUpdateMicros;
+}
+
+qreal TimerWindow::getComposedAreaRatio() const
+{
+    return m_composedAreaRatio;
+}
+
+void TimerWindow::applyRenderingMode()
+{
+    m_shapeMasked = m_appSettings->getShapeMaskEnabled();
+
+    // The translucency attribute only takes effect on a fresh native window;
+    // re-setting the flags recreates it, which also hides the window
+    bool wasVisible = isVisible();
+    setAttribute(Qt::WA_TranslucentBackground, !m_shapeMasked);
+    setWindowFlags(windowFlags());
+    if (wasVisible)
     {
-        m_timerLabel->setGraphicsEffect(nullptr); // Remove effect if disabled
+        show();
     }
 
-    // Adjust the window size based on font size and layout
-    updateWindowSize();
-    qDebug() << "Applied style:" << styleSheet;
+    updateShapeMask();
+    update();
+}
+
+void TimerWindow::updateShapeMask()
+{
+    if (!m_shapeMasked)
+    {
+        if (!mask().isEmpty())
+        {
+            clearMask();
+        }
+        m_composedAreaRatio = 1.0;
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Digit cells (shadow margins included) and whatever buttons are showing
+    QRegion region(m_timerDisplay->contentRect().translated(m_timerDisplay->pos()));
+    for (QPushButton* button : {m_startPauseButton, m_stopButton, m_skipButton, m_settingsButton, m_closeButton})
+    {
+        if (button->isVisibleTo(this))
+        {
+            region += button->geometry();
+        }
+    }
+
+    if (m_progressRing->isVisibleTo(this))
+    {
+        region += m_progressRing->shapeRegion().translated(m_progressRing->pos());
+    }
+
+    setMask(region);
+
+    qint64 maskedArea = 0;
+    for (const QRect& r : region)
+    {
+        maskedArea += qint64(r.width()) * r.height();
+    }
+    qint64 fullArea = qint64(width()) * height();
+    m_composedAreaRatio = fullArea > 0 ? qreal(maskedArea) / fullArea : 1.0;
+
+    m_maskUpdateCount++;
+    m_maskUpdateMicros += timer.nsecsElapsed() / 1000;
 }
 
 
 void TimerWindow::setupConnections()
 {
-    // Connect timer signals
-    connect(m_timer, &Timer::timerTick, this, &TimerWindow::updateTimerDisplay);
-    connect(m_timer, &Timer::modeChanged, this, &TimerWindow::handleModeChanged);
-    connect(m_timer, &Timer::stateChanged, this, &TimerWindow::handleStateChanged);
+    // Connect session events
+    connect(m_controller, &SessionController::timerTick, this, &TimerWindow::updateTimerDisplay);
+    connect(m_controller, &SessionController::modeChanged, this, &TimerWindow::handleModeChanged);
+    connect(m_controller, &SessionController::stateChanged, this, &TimerWindow::handleStateChanged);
 
     // Connect button signals
     connect(m_startPauseButton, &QPushButton::clicked, this, &TimerWindow::onStartPauseButtonClicked);
@@ -239,25 +361,37 @@ void TimerWindow::setupConnections()
 
     // Connect Settings::settingsChanged signal to TimerWindow::onSettingsChanged slot
     connect(m_appSettings, &Settings::settingsChanged, this, &TimerWindow::onSettingsChanged);
+
+    // The mask follows the digit layout (font, glyph count), not the ticking digits
+    connect(m_timerDisplay, &TimerDisplay::contentRectChanged, this, &TimerWindow::updateShapeMask);
     // connect(m_closeButton, &QPushButton::clicked, this, &QWidget::close);
     connect(m_closeButton, &QPushButton::clicked, qApp, &QApplication::quit);
-
-    connect(m_timer, &Timer::timerCompleted, this, &TimerWindow::handleTimerCompleted);
 }
 
 void TimerWindow::updateTimerDisplay(int remainingSeconds)
 {
-    int minutes = remainingSeconds / 60;
-    int seconds = remainingSeconds % 60;
-    m_timerLabel->setText(QString("%1:%2")
-                          .arg(minutes, 2, 10, QChar('0'))
-                          .arg(seconds, 2, 10, QChar('0')));
+    // Nothing to do while hidden; the display itself skips unchanged values
+    // and repaints only the digit cells that changed
+    if (!m_timer->isTickConsumerVisible())
+    {
+        return;
+    }
+
+    m_timerDisplay->setSeconds(remainingSeconds);
+
+    if (m_progressRing->isVisible())
+    {
+        int duration = m_timer->getSessionDuration();
+        m_progressRing->setProgress(duration - remainingSeconds, duration);
+    }
 }
 
 void TimerWindow::handleModeChanged(Timer::TimerMode mode)
 {
-    // Update the style with the current mode
-    updateTimerLabelStyle();
+    ZP_TRACE_SCOPE("ui", "TimerWindow::handleModeChanged");
+
+    // Switch to the precomputed style of the new mode
+    applyStyle(mode);
 
     // Update the skip button state
     switch (mode)
@@ -289,12 +423,6 @@ void TimerWindow::handleStateChanged(Timer::TimerState state)
         break;
     }
 
-    // Add this for database tracking
-    if (state == Timer::TimerState::Running && m_timer->getElapsedTime() == 0)
-    {
-        // Just started
-        m_sessionStartTime = QDateTime::currentDateTime();
-    }
     updateStartPauseButton();
 }
 
@@ -332,31 +460,13 @@ void TimerWindow::updateStartPauseIcon()
 
 void TimerWindow::onStartPauseButtonClicked()
 {
-    if (m_timer->getState() == Timer::TimerState::Running)
-    {
-        m_timer->pause();
-    }
-    else
-    {
-        m_timer->start();
-    }
+    m_controller->startPause();
 }
 
 void TimerWindow::onStopButtonClicked()
 {
-    // Add this for database tracking of interrupted sessions
-    if (m_hasDbManager && m_dbManager && !m_sessionStartTime.isNull() &&
-        m_timer->getState() != Timer::TimerState::Stopped)
-    {
-        QDateTime endTime = QDateTime::currentDateTime();
-        int duration = m_sessionStartTime.secsTo(endTime);
-
-        if (m_timer->getMode() == Timer::TimerMode::Work)
-        {
-            m_dbManager->recordPomodoroSession(m_sessionStartTime, duration, false); // incomplete
-        }
-    }
-    m_timer->reset();
+    // Records interrupted work sessions on the engine thread, then resets
+    m_controller->stop();
 }
 
 // void TimerWindow::setDatabaseManager(DatabaseManager* dbManager)
@@ -377,18 +487,55 @@ void TimerWindow::setDatabaseManager(DatabaseManager* dbManager)
     }
 }
 
+void TimerWindow::setPaintProfiler(PaintProfiler* profiler)
+{
+    m_paintProfiler = profiler;
+    m_paintStats = profiler->statsFor("TimerWindow");
+    m_timerDisplay->setPaintStats(profiler->statsFor("TimerDisplay"));
+    m_progressRing->setPaintStats(profiler->statsFor("ProgressRing"));
+
+    if (m_mainWindow)
+    {
+        m_mainWindow->setPaintProfiler(profiler);
+    }
+
+    QMenu* menu = new QMenu(this);
+    QAction* overlayAction = menu->addAction("Show paint statistics");
+    overlayAction->setCheckable(true);
+    connect(overlayAction, &QAction::toggled, profiler, &PaintProfiler::setOverlayVisible);
+    connect(profiler, &PaintProfiler::overlayVisibilityChanged, overlayAction, &QAction::setChecked);
+
+    connect(menu->addAction("Export paint statistics..."), &QAction::triggered, this, [this]()
+    {
+        QString path = QFileDialog::getSaveFileName(nullptr, "Export paint statistics",
+                                                    "paint-stats.json", "JSON (*.json)");
+        if (!path.isEmpty())
+        {
+            m_paintProfiler->exportJson(path);
+        }
+    });
+    connect(menu->addAction("Reset paint statistics"), &QAction::triggered, profiler, &PaintProfiler::reset);
+
+    m_trayIcon->setContextMenu(menu);
+}
+
 // Modify the onSettingsButtonClicked method to include the database manager
 void TimerWindow::onSettingsButtonClicked()
 {
     if (!m_mainWindow)
     {
-        m_mainWindow = new MainWindow(m_appSettings, nullptr);
+        m_mainWindow = new MainWindow(m_appSettings, m_controller, nullptr);
 
         // If we have a database manager, pass it to the MainWindow
         if (m_hasDbManager && m_dbManager)
         {
             m_mainWindow->setDatabaseManager(m_dbManager);
         }
+
+        if (m_paintProfiler)
+        {
+            m_mainWindow->setPaintProfiler(m_paintProfiler);
+        }
     }
 
     m_mainWindow->show();
@@ -398,10 +545,17 @@ void TimerWindow::onSettingsButtonClicked()
 
 void TimerWindow::paintEvent(QPaintEvent* event)
 {
-    Q_UNUSED(event);
+    ZP_TRACE_SCOPE("paint", "TimerWindow::paintEvent");
 
+    PaintScope profile(m_paintStats, event->region());
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing);
+
+    // The mask clips to the digits and buttons, so an opaque fill is all that shows
+    if (m_shapeMasked)
+    {
+        painter.fillRect(event->rect(), QColor(32, 32, 32));
+    }
 }
 
 void TimerWindow::mousePressEvent(QMouseEvent* event)
@@ -431,6 +585,46 @@ void TimerWindow::resizeEvent(QResizeEvent* event)
     {
         m_closeButton->move(this->width() - 30, 5);
     }
+
+    if (m_progressRing)
+    {
+        m_progressRing->setGeometry(rect());
+    }
+
+    updateShapeMask();
+}
+
+void TimerWindow::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    updateTickConsumer(!isMinimized());
+}
+
+void TimerWindow::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    updateTickConsumer(false);
+}
+
+void TimerWindow::changeEvent(QEvent* event)
+{
+    QWidget::changeEvent(event);
+
+    if (event->type() == QEvent::WindowStateChange)
+    {
+        updateTickConsumer(isVisible() && !isMinimized());
+    }
+}
+
+void TimerWindow::updateTickConsumer(bool visible)
+{
+    // Without a visible label the timer only needs to wake up for completion
+    m_timer->setTickConsumerVisible(visible);
+
+    if (visible)
+    {
+        updateTimerDisplay(m_timer->getRemainingTime());
+    }
 }
 
 void TimerWindow::enterEvent(QEvent* event)
@@ -440,6 +634,7 @@ void TimerWindow::enterEvent(QEvent* event)
     m_skipButton->show(); // Show skip button
     m_settingsButton->show();
     updateStartPauseButton();
+    updateShapeMask(); // The button row joins the mask while hovered
     QWidget::enterEvent(event);
 }
 
@@ -449,24 +644,28 @@ void TimerWindow::leaveEvent(QEvent* event)
     m_stopButton->hide();
     m_skipButton->hide(); // Hide skip button
     m_settingsButton->hide();
+    updateShapeMask();
     QWidget::leaveEvent(event);
 }
 
 void TimerWindow::onSettingsChanged() // <----- IMPLEMENT onSettingsChanged SLOT
 {
-    // Timer settings
-    m_timer->setWorkDuration(m_appSettings->getWorkDuration());
-    m_timer->setShortBreakDuration(m_appSettings->getShortBreakDuration());
-    m_timer->setLongBreakDuration(m_appSettings->getLongBreakDuration());
-    m_timer->setLongBreakInterval(m_appSettings->getLongBreakInterval());
+    // Timer settings are applied by the session controller
+    // Display settings: recompute the per-mode styles, then apply what changed
+    rebuildStyles();
+    applyStyle(m_timer->getMode());
 
-    // Font settings
-    QFont timerFont = m_timerLabel->font();
-    timerFont.setPointSize(m_appSettings->getFontSize());
-    m_timerLabel->setFont(timerFont);
+    if (m_progressRing->isVisibleTo(this) != m_appSettings->getProgressRingEnabled())
+    {
+        m_progressRing->setVisible(m_appSettings->getProgressRingEnabled());
+        updateWindowSize(); // The ring needs a square window
+        updateShapeMask();
+    }
 
-    // Update label style
-    updateTimerLabelStyle();
+    if (m_shapeMasked != m_appSettings->getShapeMaskEnabled())
+    {
+        applyRenderingMode();
+    }
 
     // Force an immediate update of the timer display
     updateTimerDisplay(m_timer->getRemainingTime());
@@ -481,11 +680,7 @@ void TimerWindow::onSettingsChanged() // <----- IMPLEMENT onSettingsChanged SLOT
 void TimerWindow::onSkipButtonClicked()
 {
     // Skip current break and move to next work session
-    if (m_timer->getMode() == Timer::TimerMode::ShortBreak ||
-        m_timer->getMode() == Timer::TimerMode::LongBreak)
-    {
-        m_timer->skipBreak(); // We need to add this method to the Timer class
-    }
+    m_controller->skipBreak();
 }
 
 void TimerWindow::updateWindowSize()
@@ -499,106 +694,14 @@ void TimerWindow::updateWindowSize()
     // Add small padding
     int padding = 10;
 
-    // Resize the window to tightly fit the timer text
-    resize(textWidth + padding, textHeight + padding);
-
-    qDebug() << "Window resized to:" << width() << "x" << height();
-}
-
-// Add this method to your TimerWindow implementation
-
-// Implement the new slot for timer completion
-void TimerWindow::handleTimerCompleted(Timer::TimerMode completedMode)
-{
-    if (!m_hasDbManager || !m_dbManager)
-    {
-        return; // Skip database recording if no DB manager
-    }
-
-    QDateTime endTime = QDateTime::currentDateTime();
-    int duration = m_sessionStartTime.secsTo(endTime);
-
-    if (completedMode == Timer::TimerMode::Work)
-    {
-        m_dbManager->recordPomodoroSession(m_sessionStartTime, duration, true);
-    }
-    else if (completedMode == Timer::TimerMode::ShortBreak)
-    {
-        m_dbManager->recordBreakSession(m_sessionStartTime, duration, false);
-    }
-    else if (completedMode == Timer::TimerMode::LongBreak)
-    {
-        m_dbManager->recordBreakSession(m_sessionStartTime, duration, true);
-    }
-
-    QString title;
-    QString message;
-
-    if (completedMode == Timer::TimerMode::Work)
-    {
-        title = "Work Session Complete!";
-        message = "Time for a break.";
-    }
-    else if (completedMode == Timer::TimerMode::ShortBreak || completedMode == Timer::TimerMode::LongBreak)
-    {
-        title = "Break Over!";
-        message = "Time to get back to work.";
-    }
-
-    // Show notification - using existing setting name
-    if (m_appSettings->getDesktopNotificationsEnabled())
-    {
-        showDesktopNotification(title, message);
-    }
-
-    // Play sound - using existing setting name
-    if (m_appSettings->getSoundEnabled())
-    {
-        playNotificationSound();
-    }
-}
-
-// void TimerWindow::playNotificationSound()
-// {
-// #ifdef HAVE_QT_MULTIMEDIA // Keep the conditional compilation if it's important for your build
-//     if (m_appSettings->getSoundEnabled()) // Use m_appSettings here
-//     {
-//         m_mediaPlayer->setMedia(QUrl::fromLocalFile(m_appSettings->getSoundFile())); // Use m_appSettings here
-//         m_mediaPlayer->play();
-//     }
-// #endif
-// }
-//
-
-void TimerWindow::playNotificationSound()
-{
-#ifdef HAVE_QT_MULTIMEDIA
-    if (m_appSettings->getSoundEnabled())
+    if (m_appSettings->getProgressRingEnabled())
     {
-        QString soundFile = m_appSettings->getSoundFile();
-
-        // Check if it's a QRC path (starts with ":/")
-        QUrl mediaUrl;
-        if (soundFile.startsWith(":/"))
-        {
-            mediaUrl = QUrl("qrc" + soundFile); // Convert ":/" to "qrc:/"
-        }
-        else
-        {
-            mediaUrl = QUrl::fromLocalFile(soundFile); // Assume it's a filesystem path
-        }
-
-        m_mediaPlayer->setMedia(mediaUrl);
-        m_mediaPlayer->play();
+        // Square, with the ring around the text
+        int side = textWidth + 4 * padding;
+        resize(side, side);
+        return;
     }
-#endif
-}
-
 
-void TimerWindow::showDesktopNotification(const QString& title, const QString& message)
-{
-    if (m_appSettings->getDesktopNotificationsEnabled()) // Use m_appSettings, keep existing name
-    {
-        m_trayIcon->showMessage(title, message, QSystemTrayIcon::Information, 3000);
-    }
+    // Resize the window to tightly fit the timer text
+    resize(textWidth + padding, textHeight + padding);
 }
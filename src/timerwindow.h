@@ -10,38 +10,53 @@
 #include <QPushButton>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
-#include <QMediaPlayer> // For sound
 #include <QSystemTrayIcon> // For notifications
 
-#include "timer.h"
+#include "sessioncontroller.h"
+#include "timerdisplay.h"
+#include "progressring.h"
+#include "sessionnotifier.h"
 #include "mainwindow.h"
 #include "settings.h"
 #include "databasemanager.h" // Add include for DatabaseManager
+#include "paintprofiler.h"
 
 class TimerWindow : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit TimerWindow(Settings* settings, QWidget* parent = nullptr);
+    TimerWindow(Settings* settings, SessionController* controller, QWidget* parent = nullptr);
     ~TimerWindow() override;
 
-    // Access to internal timer for MainWindow
-    Timer* getTimer() const { return m_timer; }
-
     // Set the database manager
     void setDatabaseManager(DatabaseManager* dbManager);
 
+    // Route paint timings of this window, its children and MainWindow's
+    // activity map to the profiler; adds overlay/export entries to the tray
+    void setPaintProfiler(PaintProfiler* profiler);
+
+    // Style applications that actually changed something; plain ticks never add to it
+    int getRestyleCount() const;
+
+    // Shape-masked mode: how often the mask was rebuilt, what that cost, and
+    // the share of the window the compositor still has to blend (1.0 when unmasked)
+    int getMaskUpdateCount() const;
+    qint64 getMaskUpdateMicros() const;
+    qreal getComposedAreaRatio() const;
+
 protected:
     void paintEvent(QPaintEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    void changeEvent(QEvent* event) override;
 
 private slots:
     void updateTimerDisplay(int remainingSeconds);
     void handleModeChanged(Timer::TimerMode mode);
     void handleStateChanged(Timer::TimerState state);
-    void handleTimerCompleted(Timer::TimerMode completedMode); // New slot for timer completion
     void onStartPauseButtonClicked();
     void onStopButtonClicked();
     void onSettingsButtonClicked();
@@ -49,20 +64,36 @@ private slots:
     void enterEvent(QEvent* event) override;
     void leaveEvent(QEvent* event) override;
     void onSettingsChanged();
-    void playNotificationSound();
-    void showDesktopNotification(const QString& title, const QString& message);
 
 private:
+    // Everything the display needs for one mode, derived from settings once
+    struct TimerStyle
+    {
+        QFont font;
+        QColor textColor;
+        QColor backgroundColor;
+        bool shadowEnabled = false;
+        QPointF shadowOffset;
+        qreal shadowBlur = 0;
+        QColor shadowColor;
+        int fontSize = 0;
+    };
+
     void setupUi();
-    void updateTimerLabelStyle();
+    void rebuildStyles(); // Settings -> per-mode styles
+    void applyStyle(Timer::TimerMode mode); // Pushes only what differs from the applied style
     void setupConnections();
     void updateStartPauseButton();
+    void updateTickConsumer(bool visible);
+    void applyRenderingMode(); // Translucent or shape-masked, from settings
+    void updateShapeMask(); // Only called on layout changes, never per tick
 
-    QMediaPlayer* m_mediaPlayer;
     QSystemTrayIcon* m_trayIcon;
+    SessionNotifier* m_notifier; // Sound and desktop notifications
 
     // UI Components
-    QLabel* m_timerLabel;
+    TimerDisplay* m_timerDisplay;
+    ProgressRing* m_progressRing; // Behind everything, covers the whole window
     QPushButton* m_startPauseButton;
     QPushButton* m_stopButton;
     QPushButton* m_settingsButton;
@@ -72,23 +103,36 @@ private:
     QPushButton* m_skipButton;
 
     // Core components
-    Timer* m_timer;
+    SessionController* m_controller; // Owns the engine shared with MainWindow
+    ThreadedTimer* m_timer; // m_controller's engine, read for display state
     MainWindow* m_mainWindow;
     DatabaseManager* m_dbManager; // Add database manager member
-
-    // Session tracking
-    QDateTime m_sessionStartTime; // Track when the current session started
     bool m_hasDbManager; // Flag to check if DB manager is set and initialized
 
+    // Style state
+    TimerStyle m_styles[3]; // Indexed by Timer::TimerMode
+    TimerStyle m_appliedStyle;
+    bool m_hasAppliedStyle = false;
+    int m_restyleCount = 0;
+
+    // Shape-masked rendering state
+    bool m_shapeMasked = false;
+    int m_maskUpdateCount = 0;
+    qint64 m_maskUpdateMicros = 0;
+    qreal m_composedAreaRatio = 1.0;
+
     // For window dragging
     QPoint m_dragPosition;
 
+
     bool isRunning = false; // Track if timer is running
     void updateStartPauseIcon();
     void onSkipButtonClicked();
     void updateWindowSize();
 
     Settings* m_appSettings;
+    PaintProfiler* m_paintProfiler = nullptr;
+    PaintStats* m_paintStats = nullptr;
 };
 
 #endif // ZIGA_POMODORO_TIMERWINDOW_H
@@ -0,0 +1,219 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "trace.h"
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QThread>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include <atomic>
+
+namespace
+{
+    // One ring slot. sequence is index + 1 once the slot holds that event and
+    // 0 while it is being written, so export can skip torn slots
+    struct TraceEvent
+    {
+        std::atomic<quint64> sequence{0};
+        const char* category = nullptr;
+        const char* name = nullptr;
+        qint64 startNanos = 0;
+        qint64 durationNanos = 0;
+        quint32 thread = 0;
+        char phase = 'X';
+    };
+
+    TraceEvent g_events[Trace::kCapacity];
+    std::atomic<quint64> g_next{0};
+    std::atomic<bool> g_enabled{true};
+
+    // Small thread ids, named once per thread for the trace viewer. Each
+    // thread writes only its own slot, then publishes it with ready
+    constexpr quint32 kMaxNamedThreads = 256;
+
+    struct ThreadName
+    {
+        std::atomic<bool> ready{false};
+        char name[48] = {};
+    };
+
+    ThreadName g_threadNames[kMaxNamedThreads];
+    std::atomic<quint32> g_nextThread{1};
+    thread_local quint32 t_thread = 0;
+
+    QElapsedTimer& timebase()
+    {
+        static QElapsedTimer timer = []()
+        {
+            QElapsedTimer started;
+            started.start();
+            return started;
+        }();
+        return timer;
+    }
+
+    quint32 currentThread()
+    {
+        if (t_thread == 0)
+        {
+            t_thread = g_nextThread.fetch_add(1, std::memory_order_relaxed);
+            if (t_thread >= kMaxNamedThreads)
+            {
+                return t_thread; // Exported under its number only
+            }
+
+            QThread* thread = QThread::currentThread();
+            QByteArray name = thread->objectName().toUtf8();
+            if (name.isEmpty())
+            {
+                bool isMain = QCoreApplication::instance() && QCoreApplication::instance()->thread() == thread;
+                name = isMain ? QByteArray("main") : QByteArray("thread ") + QByteArray::number(t_thread);
+            }
+
+            ThreadName& slot = g_threadNames[t_thread];
+            qstrncpy(slot.name, name.constData(), sizeof(slot.name));
+            slot.ready.store(true, std::memory_order_release);
+        }
+        return t_thread;
+    }
+
+    void record(char phase, const char* category, const char* name, qint64 startNanos, qint64 durationNanos)
+    {
+        quint64 index = g_next.fetch_add(1, std::memory_order_relaxed);
+        TraceEvent& event = g_events[index % Trace::kCapacity];
+
+        event.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        event.category = category;
+        event.name = name;
+        event.startNanos = startNanos;
+        event.durationNanos = durationNanos;
+        event.thread = currentThread();
+        event.phase = phase;
+        event.sequence.store(index + 1, std::memory_order_release);
+    }
+}
+
+void Trace::setEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool Trace::isEnabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+qint64 Trace::nowNanos()
+{
+    return timebase().nsecsElapsed();
+}
+
+void Trace::complete(const char* category, const char* name, qint64 startNanos, qint64 endNanos)
+{
+    record('X', category, name, startNanos, endNanos - startNanos);
+}
+
+void Trace::instant(const char* category, const char* name)
+{
+    if (isEnabled())
+    {
+        record('i', category, name, nowNanos(), 0);
+    }
+}
+
+QByteArray Trace::toJson()
+{
+    QJsonArray events;
+
+    const quint64 end = g_next.load(std::memory_order_acquire);
+    const quint64 begin = end > quint64(kCapacity) ? end - kCapacity : 0;
+    for (quint64 index = begin; index < end; index++)
+    {
+        const TraceEvent& slot = g_events[index % kCapacity];
+
+        // Copy, then make sure no writer touched the slot meanwhile
+        quint64 before = slot.sequence.load(std::memory_order_acquire);
+        const char* category = slot.category;
+        const char* name = slot.name;
+        qint64 startNanos = slot.startNanos;
+        qint64 durationNanos = slot.durationNanos;
+        quint32 thread = slot.thread;
+        char phase = slot.phase;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (before != index + 1 || slot.sequence.load(std::memory_order_relaxed) != before)
+        {
+            continue;
+        }
+
+        // Chrome trace timestamps are microseconds
+        QJsonObject event;
+        event["name"] = QString::fromLatin1(name);
+        event["cat"] = QString::fromLatin1(category);
+        event["ph"] = QString(QChar(phase));
+        event["ts"] = startNanos / 1000.0;
+        event["pid"] = 1;
+        event["tid"] = int(thread);
+        if (phase == 'X')
+        {
+            event["dur"] = durationNanos / 1000.0;
+        }
+        else
+        {
+            event["s"] = "t"; // Instant scoped to its thread
+        }
+        events.append(event);
+    }
+
+    const quint32 threadCount = qMin(g_nextThread.load(std::memory_order_relaxed), kMaxNamedThreads);
+    for (quint32 thread = 1; thread < threadCount; thread++)
+    {
+        const ThreadName& slot = g_threadNames[thread];
+        if (!slot.ready.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+
+        QJsonObject args;
+        args["name"] = QString::fromUtf8(slot.name);
+
+        QJsonObject metadata;
+        metadata["name"] = "thread_name";
+        metadata["ph"] = "M";
+        metadata["pid"] = 1;
+        metadata["tid"] = int(thread);
+        metadata["args"] = args;
+        events.append(metadata);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool Trace::exportJson(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+
+    QByteArray json = toJson();
+    return file.write(json) == json.size();
+}
+
+void Trace::clear()
+{
+    g_next.store(0, std::memory_order_relaxed);
+    for (TraceEvent& event : g_events)
+    {
+        event.sequence.store(0, std::memory_order_relaxed);
+    }
+}
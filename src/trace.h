@@ -0,0 +1,75 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_TRACE_H
+#define ZIGA_POMODORO_TRACE_H
+
+#include <QtGlobal>
+#include <QString>
+#include <QByteArray>
+
+// Scoped trace events in a fixed-size ring buffer, exported as Chrome trace
+// event JSON (chrome://tracing, Perfetto). Recording is a timestamp and a few
+// stores into a preallocated slot, with no locks, so it can stay on in
+// production; the oldest events are overwritten. The only allocation is a
+// thread's first event, which copies the thread name into a fixed table.
+//
+// Names and categories must be string literals: only the pointers are kept.
+// Without the ZIGA_POMODORO_TRACE build option the macros compile to nothing.
+class Trace
+{
+public:
+    static constexpr int kCapacity = 1 << 16; // Events kept
+
+    static void setEnabled(bool enabled); // On by default when compiled in
+    static bool isEnabled();
+
+    static qint64 nowNanos(); // Since the first trace call
+    static void complete(const char* category, const char* name, qint64 startNanos, qint64 endNanos);
+    static void instant(const char* category, const char* name);
+
+    static QByteArray toJson(); // Events still in the buffer, oldest first
+    static bool exportJson(const QString& filePath);
+    static void clear();
+};
+
+// Records the enclosing scope as one complete ("X") event
+class TraceScope
+{
+public:
+    TraceScope(const char* category, const char* name)
+        : m_category(category)
+          , m_name(name)
+          , m_start(Trace::isEnabled() ? Trace::nowNanos() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_start >= 0)
+        {
+            Trace::complete(m_category, m_name, m_start, Trace::nowNanos());
+        }
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_category;
+    const char* m_name;
+    qint64 m_start;
+};
+
+#ifdef ZIGA_POMODORO_TRACE
+#define ZP_TRACE_CONCAT_(a, b) a##b
+#define ZP_TRACE_CONCAT(a, b) ZP_TRACE_CONCAT_(a, b)
+#define ZP_TRACE_SCOPE(category, name) TraceScope ZP_TRACE_CONCAT(zpTraceScope_, __LINE__)(category, name)
+#define ZP_TRACE_INSTANT(category, name) Trace::instant(category, name)
+#else
+#define ZP_TRACE_SCOPE(category, name) do { } while (false)
+#define ZP_TRACE_INSTANT(category, name) do { } while (false)
+#endif
+
+#endif // ZIGA_POMODORO_TRACE_H
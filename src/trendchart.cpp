@@ -0,0 +1,330 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#include "trendchart.h"
+#include "trace.h"
+#include "lttb.h"
+#include "paintprofiler.h"
+#include <QPainter>
+#include <QPaintEvent>
+
+namespace
+{
+// Margins around the plot area, room for axis labels
+constexpr int kPlotLeft = 44;
+constexpr int kPlotTop = 22;
+constexpr int kPlotRight = 10;
+constexpr int kPlotBottom = 22;
+
+constexpr int kCacheEntries = 32;
+
+const QColor kValueColor(64, 196, 99);
+const QColor kAverageColor(25, 97, 39);
+const QColor kGridColor(0, 0, 0, 30);
+}
+
+TrendChart::TrendChart(QWidget* parent)
+    : QWidget(parent)
+      , m_dbManager(nullptr)
+      , m_paintStats(nullptr)
+      , m_granularity(ActivityGranularity::Day)
+      , m_metric(Metric::Pomodoros)
+      , m_cache(kCacheEntries)
+{
+    setMinimumHeight(160);
+
+    // Default to the last 3 months, like the activity map
+    m_endDate = Clock::instance()->currentDate();
+    m_startDate = m_endDate.addMonths(-3);
+    loadRaw();
+}
+
+TrendChart::~TrendChart() = default;
+
+void TrendChart::setDatabaseManager(DatabaseManager* dbManager)
+{
+    m_dbManager = dbManager;
+    m_cache.clear();
+    loadRaw();
+    update();
+}
+
+void TrendChart::setDateRange(const QDate& startDate, const QDate& endDate)
+{
+    if (startDate == m_startDate && endDate == m_endDate)
+    {
+        return;
+    }
+
+    // Cached series of earlier ranges stay valid; only the raw data is per range
+    m_startDate = startDate;
+    m_endDate = endDate;
+    loadRaw();
+    update();
+}
+
+void TrendChart::setPaintStats(PaintStats* stats)
+{
+    m_paintStats = stats;
+}
+
+TrendChart::Metric TrendChart::getMetric() const
+{
+    return m_metric;
+}
+
+void TrendChart::setMetric(Metric metric)
+{
+    if (metric != m_metric)
+    {
+        m_metric = metric; // The raw data has both metrics
+        update();
+    }
+}
+
+ActivityGranularity TrendChart::getGranularity() const
+{
+    return m_granularity;
+}
+
+void TrendChart::setGranularity(ActivityGranularity granularity)
+{
+    // Months are too few points for a trend line
+    if (granularity == ActivityGranularity::Month)
+    {
+        granularity = ActivityGranularity::Week;
+    }
+
+    if (granularity != m_granularity)
+    {
+        m_granularity = granularity;
+        loadRaw();
+        update();
+    }
+}
+
+int TrendChart::getCachedSeriesCount() const
+{
+    return m_cache.count();
+}
+
+void TrendChart::onSessionRecorded(const RecordedSession& session)
+{
+    if (session.kind != RecordedSession::Kind::Work)
+    {
+        return;
+    }
+
+    // Any cached range may contain the new session
+    m_cache.clear();
+
+    QDate date = session.record.startTime.date();
+    if (date >= m_startDate && date <= m_endDate)
+    {
+        qint64 days = m_firstBucketDate.daysTo(date);
+        int index = int(m_granularity == ActivityGranularity::Week ? days / 7 : days);
+        if (index >= 0 && index < m_pomodoros.size())
+        {
+            m_pomodoros[index] += session.record.completed ? 1 : 0;
+            m_seconds[index] += session.record.durationSeconds;
+        }
+    }
+
+    update();
+}
+
+void TrendChart::loadRaw()
+{
+    ZP_TRACE_SCOPE("db", "TrendChart::loadRaw");
+
+    m_pomodoros.clear();
+    m_seconds.clear();
+
+    if (!m_startDate.isValid() || !m_endDate.isValid() || m_startDate > m_endDate)
+    {
+        return;
+    }
+
+    // Weeks start on Monday, as in the database's weekly buckets
+    bool weekly = m_granularity == ActivityGranularity::Week;
+    m_firstBucketDate = weekly ? m_startDate.addDays(1 - m_startDate.dayOfWeek()) : m_startDate;
+    qint64 days = m_firstBucketDate.daysTo(m_endDate);
+    int count = int(weekly ? days / 7 : days) + 1;
+
+    // Buckets without sessions are not returned, so every bucket starts at zero
+    m_pomodoros.fill(0, count);
+    m_seconds.fill(0, count);
+
+    if (!m_dbManager || !m_dbManager->isInitialized())
+    {
+        return;
+    }
+
+    const QList<ActivityBucket> buckets = m_dbManager->getActivityBuckets(m_startDate, m_endDate, m_granularity);
+    for (const ActivityBucket& bucket : buckets)
+    {
+        days = m_firstBucketDate.daysTo(bucket.start);
+        int index = int(weekly ? days / 7 : days);
+        if (index >= 0 && index < count)
+        {
+            m_pomodoros[index] = bucket.pomodoros;
+            m_seconds[index] = bucket.seconds;
+        }
+    }
+}
+
+QString TrendChart::cacheKey(int plotWidth) const
+{
+    return QString("%1|%2|%3|%4|%5")
+           .arg(m_startDate.toString(Qt::ISODate), m_endDate.toString(Qt::ISODate))
+           .arg(static_cast<int>(m_granularity))
+           .arg(static_cast<int>(m_metric))
+           .arg(plotWidth);
+}
+
+const TrendChart::Series* TrendChart::currentSeries(int plotWidth)
+{
+    QString key = cacheKey(plotWidth);
+    if (const Series* cached = m_cache.object(key))
+    {
+        return cached;
+    }
+
+    // The raw series is loaded by the setters, so painting never queries
+    // Metric and its trailing average in one pass over the raw buckets
+    const int count = m_pomodoros.size();
+    const int window = averageWindow();
+    QVector<QPointF> values(count);
+    QVector<QPointF> average(count);
+    double maxValue = 0.0;
+    double windowSum = 0.0;
+
+    for (int i = 0; i < count; i++)
+    {
+        double value = m_metric == Metric::Pomodoros ? m_pomodoros[i] : m_seconds[i] / 60.0;
+        windowSum += value;
+        if (i >= window)
+        {
+            windowSum -= m_metric == Metric::Pomodoros ? m_pomodoros[i - window] : m_seconds[i - window] / 60.0;
+        }
+
+        values[i] = QPointF(i, value);
+        average[i] = QPointF(i, windowSum / qMin(i + 1, window));
+        maxValue = qMax(maxValue, value);
+    }
+
+    // About one point per pixel column, however long the range
+    auto* series = new Series;
+    series->values = Lttb::downsample(values, plotWidth);
+    series->average = Lttb::downsample(average, plotWidth);
+    series->maxValue = maxValue;
+    series->bucketCount = count;
+    series->firstBucketDate = m_firstBucketDate;
+
+    m_cache.insert(key, series);
+    return series;
+}
+
+int TrendChart::averageWindow() const
+{
+    return m_granularity == ActivityGranularity::Week ? 4 : 7;
+}
+
+QString TrendChart::averageLabel() const
+{
+    return m_granularity == ActivityGranularity::Week ? "4-week average" : "7-day average";
+}
+
+QRect TrendChart::plotRect() const
+{
+    return QRect(kPlotLeft, kPlotTop, qMax(1, width() - kPlotLeft - kPlotRight),
+                 qMax(1, height() - kPlotTop - kPlotBottom));
+}
+
+void TrendChart::paintEvent(QPaintEvent* event)
+{
+    ZP_TRACE_SCOPE("paint", "TrendChart::paintEvent");
+
+    PaintScope profile(m_paintStats, event->region());
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const QRect plot = plotRect();
+    const Series* series = currentSeries(plot.width());
+    const int count = series->bucketCount;
+    QColor textColor = palette().color(QPalette::WindowText);
+
+    QFont smallFont = font();
+    smallFont.setPointSize(qMax(6, smallFont.pointSize() - 2));
+    painter.setFont(smallFont);
+
+    // Legend
+    QFontMetrics metrics(smallFont);
+    QString valueLabel = m_metric == Metric::Pomodoros ? "Pomodoros" : "Minutes";
+    int legendX = plot.right() - metrics.horizontalAdvance(valueLabel) - metrics.horizontalAdvance(averageLabel()) - 50;
+    painter.setPen(QPen(kValueColor, 2));
+    painter.drawLine(legendX, 10, legendX + 12, 10);
+    painter.setPen(textColor);
+    painter.drawText(legendX + 16, 14, valueLabel);
+    legendX += 16 + metrics.horizontalAdvance(valueLabel) + 12;
+    painter.setPen(QPen(kAverageColor, 2, Qt::DashLine));
+    painter.drawLine(legendX, 10, legendX + 12, 10);
+    painter.setPen(textColor);
+    painter.drawText(legendX + 16, 14, averageLabel());
+
+    if (count == 0)
+    {
+        painter.drawText(plot, Qt::AlignCenter, "No data");
+        return;
+    }
+
+    // Gridlines at zero, half and the maximum
+    double maxY = qMax(1.0, series->maxValue);
+    for (int step = 0; step <= 2; step++)
+    {
+        int y = plot.bottom() - step * plot.height() / 2;
+        painter.setPen(kGridColor);
+        painter.drawLine(plot.left(), y, plot.right(), y);
+        painter.setPen(textColor);
+        painter.drawText(QRect(0, y - 8, kPlotLeft - 6, 16), Qt::AlignRight | Qt::AlignVCenter,
+                         QString::number(maxY * step / 2, 'f', maxY < 4 ? 1 : 0));
+    }
+
+    // First, middle and last bucket dates
+    const int labelBuckets[] = {0, (count - 1) / 2, count - 1};
+    for (int i = 0; i < (count > 2 ? 3 : 1); i++)
+    {
+        int bucket = labelBuckets[i];
+        QDate date = m_granularity == ActivityGranularity::Week
+                         ? series->firstBucketDate.addDays(7 * bucket)
+                         : series->firstBucketDate.addDays(bucket);
+        int x = plot.left() + (count > 1 ? bucket * plot.width() / (count - 1) : 0);
+        int alignment = i == 0 ? Qt::AlignLeft : (i == 2 ? Qt::AlignRight : Qt::AlignHCenter);
+        int textWidth = 80;
+        int textLeft = i == 0 ? x : (i == 2 ? x - textWidth : x - textWidth / 2);
+        painter.drawText(QRect(textLeft, plot.bottom() + 4, textWidth, kPlotBottom - 4),
+                         alignment | Qt::AlignTop, date.toString("MMM d"));
+    }
+
+    // Data coordinates to pixels
+    double xScale = count > 1 ? double(plot.width()) / (count - 1) : 0.0;
+    double yScale = plot.height() / maxY;
+    auto toPolygon = [&](const QVector<QPointF>& points)
+    {
+        QPolygonF polygon;
+        polygon.reserve(points.size());
+        for (const QPointF& point : points)
+        {
+            polygon.append(QPointF(plot.left() + point.x() * xScale, plot.bottom() - point.y() * yScale));
+        }
+        return polygon;
+    };
+
+    painter.setClipRect(plot.adjusted(-2, -2, 2, 2));
+    painter.setPen(QPen(kValueColor, 1.5));
+    painter.drawPolyline(toPolygon(series->values));
+    painter.setPen(QPen(kAverageColor, 2, Qt::DashLine));
+    painter.drawPolyline(toPolygon(series->average));
+}
@@ -0,0 +1,87 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+#ifndef ZIGA_POMODORO_TRENDCHART_H
+#define ZIGA_POMODORO_TRENDCHART_H
+
+#include <QWidget>
+#include <QVector>
+#include <QPointF>
+#include <QDate>
+#include <QCache>
+
+#include "databasemanager.h" // ActivityGranularity, RecordedSession
+
+class PaintStats;
+
+// Daily or weekly line chart of the selected range: one metric per bucket
+// and its trailing average. Long ranges are reduced with LTTB to about one
+// point per pixel column, and the reduced series are cached per range,
+// level, metric and plot width, so a repaint never walks the raw data.
+class TrendChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum class Metric
+    {
+        Pomodoros,
+        Minutes
+    };
+
+    explicit TrendChart(QWidget* parent = nullptr);
+    ~TrendChart() override;
+
+    void setDatabaseManager(DatabaseManager* dbManager);
+    void setDateRange(const QDate& startDate, const QDate& endDate);
+    void setPaintStats(PaintStats* stats); // Null turns profiling off
+
+    Metric getMetric() const;
+    void setMetric(Metric metric);
+    ActivityGranularity getGranularity() const;
+    void setGranularity(ActivityGranularity granularity); // Day or Week
+
+    int getCachedSeriesCount() const;
+
+public slots:
+    void onSessionRecorded(const RecordedSession& session); // Updates the raw series without a query
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+
+private:
+    // What gets drawn: both lines in data coordinates (x = bucket index)
+    struct Series
+    {
+        QVector<QPointF> values;
+        QVector<QPointF> average;
+        double maxValue = 0.0;
+        int bucketCount = 0;
+        QDate firstBucketDate; // Raw data may since belong to another range
+    };
+
+    const Series* currentSeries(int plotWidth); // From the cache, downsampling on a miss
+    void loadRaw(); // One query for the range; run when the range, level or database changes
+    QString cacheKey(int plotWidth) const;
+    int averageWindow() const; // 7 days or 4 weeks
+    QString averageLabel() const;
+    QRect plotRect() const;
+
+    DatabaseManager* m_dbManager;
+    PaintStats* m_paintStats;
+
+    QDate m_startDate;
+    QDate m_endDate;
+    ActivityGranularity m_granularity;
+    Metric m_metric;
+
+    // Full resolution for the current range and level, one entry per bucket
+    QDate m_firstBucketDate;
+    QVector<int> m_pomodoros;
+    QVector<int> m_seconds;
+
+    QCache<QString, Series> m_cache;
+};
+
+#endif // ZIGA_POMODORO_TRENDCHART_H
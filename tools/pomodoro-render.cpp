@@ -0,0 +1,260 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+// Headless batch render of activity heatmaps: each database given on the
+// command line becomes one PNG (or SVG) in the output directory. Databases
+// are opened read-only and rendered in parallel on the global thread pool.
+// Outputs are named after the database file, or after its directory plus
+// the file when several inputs share a file name (alice/ziga_pomodoro.db
+// becomes alice-ziga_pomodoro.png).
+//
+// Output depends only on the inputs, the Qt version and the installed fonts:
+// the C locale is used for labels, hinting is off and no timestamps are
+// written, so identical data gives byte-identical files that can be cached.
+
+#include "activitymaprenderer.h"
+#include "databasemanager.h"
+
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QDir>
+#include <QHash>
+#include <QSet>
+#include <QImageWriter>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QTextStream>
+
+namespace
+{
+    struct RenderOptions
+    {
+        QDate from;
+        QDate to;
+        ActivityGranularity granularity = ActivityGranularity::Day;
+        QDir outDir;
+        bool svg = false;
+    };
+
+    // Fixed font and colours so nothing depends on the desktop environment
+    QFont renderFont()
+    {
+        QFont font("DejaVu Sans");
+        font.setPixelSize(11);
+        font.setHintingPreference(QFont::PreferNoHinting);
+        return font;
+    }
+
+    // Output base names, unique within the batch; empty if they cannot be
+    QStringList outputNames(const QStringList& databases)
+    {
+        QHash<QString, int> fileNameCount;
+        for (const QString& database : databases)
+        {
+            fileNameCount[QFileInfo(database).completeBaseName()]++;
+        }
+
+        QStringList names;
+        QSet<QString> taken;
+        for (const QString& database : databases)
+        {
+            QFileInfo info(database);
+            QString name = info.completeBaseName();
+            if (fileNameCount.value(name) > 1)
+            {
+                name = info.absoluteDir().dirName() + "-" + name;
+            }
+
+            if (taken.contains(name))
+            {
+                QTextStream(stderr) << "Two inputs would both write " << name << "; rename one of them\n";
+                return QStringList();
+            }
+            taken.insert(name);
+            names.append(name);
+        }
+        return names;
+    }
+
+    class RenderJob : public QRunnable
+    {
+    public:
+        RenderJob(int index, const QString& dbPath, const QString& outName, const RenderOptions& options,
+                  QAtomicInt* failures)
+            : m_index(index)
+              , m_dbPath(dbPath)
+              , m_outName(outName)
+              , m_options(options)
+              , m_failures(failures)
+        {
+        }
+
+        void run() override
+        {
+            if (!render())
+            {
+                m_failures->ref();
+            }
+        }
+
+    private:
+        bool render()
+        {
+            {
+                // SQLite connections are per thread, so each job opens its own
+                DatabaseManager dbManager;
+                dbManager.setConnectionName(QString("render-%1").arg(m_index));
+                dbManager.setDatabasePath(m_dbPath);
+                dbManager.setReadOnly(true);
+                if (!dbManager.initialize())
+                {
+                    QTextStream(stderr) << "Failed to open database " << m_dbPath << "\n";
+                    return false;
+                }
+
+                m_renderer.setDateRange(m_options.from, m_options.to, m_options.granularity);
+                m_renderer.setLocale(QLocale::c());
+                if (!m_renderer.loadAll(&dbManager))
+                {
+                    return false;
+                }
+            }
+
+            if (m_options.svg)
+            {
+                QString outPath = m_options.outDir.filePath(m_outName + ".svg");
+                if (!m_renderer.renderSvg(outPath, renderFont(), Qt::black, Qt::white))
+                {
+                    QTextStream(stderr) << "Failed to write " << outPath << " (built without QtSvg?)\n";
+                    return false;
+                }
+                return true;
+            }
+
+            // Opaque RGB with default writer settings: no gamma or time chunks
+            QImage image = m_renderer.renderImage(renderFont(), Qt::black, Qt::white)
+                               .convertToFormat(QImage::Format_RGB32);
+            image.setDotsPerMeterX(3780); // 96 dpi rather than whatever the screen reports
+            image.setDotsPerMeterY(3780);
+
+            QString outPath = m_options.outDir.filePath(m_outName + ".png");
+            QImageWriter writer(outPath, "png");
+            if (!writer.write(image))
+            {
+                QTextStream(stderr) << "Failed to write " << outPath << ": " << writer.errorString() << "\n";
+                return false;
+            }
+            return true;
+        }
+
+        int m_index;
+        QString m_dbPath;
+        QString m_outName;
+        RenderOptions m_options;
+        QAtomicInt* m_failures;
+        ActivityMapRenderer m_renderer;
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    // No display needed
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pomodoro-render");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Render Ziga-Pomodoro activity heatmaps without a display");
+    parser.addHelpOption();
+    parser.addOption({"from", "First day, YYYY-MM-DD (default: a year before --to).", "date"});
+    parser.addOption({"to", "Last day, YYYY-MM-DD (default: today).", "date"});
+    parser.addOption({"granularity", "day, week or month (default day).", "level", "day"});
+    parser.addOption({"out", "Output directory (default: current directory).", "dir", "."});
+    parser.addOption({"svg", "Write SVG instead of PNG."});
+    parser.addOption({"jobs", "Parallel renders (default: one per core).", "count"});
+    parser.addPositionalArgument("databases",
+                                 "Database files to render; outputs are named after them (and their "
+                                 "directory when file names repeat).",
+                                 "<db>...");
+    parser.process(app);
+
+    const QStringList databases = parser.positionalArguments();
+    if (databases.isEmpty())
+    {
+        parser.showHelp(1);
+    }
+
+    // Parallel jobs must never write the same file
+    const QStringList names = outputNames(databases);
+    if (names.isEmpty())
+    {
+        return 1;
+    }
+
+    RenderOptions options;
+    options.to = parser.isSet("to") ? QDate::fromString(parser.value("to"), Qt::ISODate) : QDate::currentDate();
+    options.from = parser.isSet("from")
+                       ? QDate::fromString(parser.value("from"), Qt::ISODate)
+                       : options.to.addYears(-1).addDays(1);
+    if (!options.from.isValid() || !options.to.isValid() || options.from > options.to)
+    {
+        QTextStream(stderr) << "Invalid date range\n";
+        return 1;
+    }
+
+    QString granularity = parser.value("granularity");
+    if (granularity == "week")
+    {
+        options.granularity = ActivityGranularity::Week;
+    }
+    else if (granularity == "month")
+    {
+        options.granularity = ActivityGranularity::Month;
+    }
+    else if (granularity != "day")
+    {
+        QTextStream(stderr) << "Unknown granularity " << granularity << "\n";
+        return 1;
+    }
+
+    options.outDir = QDir(parser.value("out"));
+    if (!options.outDir.mkpath("."))
+    {
+        QTextStream(stderr) << "Cannot create " << options.outDir.path() << "\n";
+        return 1;
+    }
+    options.svg = parser.isSet("svg");
+
+    QThreadPool* pool = QThreadPool::globalInstance();
+    if (parser.isSet("jobs"))
+    {
+        pool->setMaxThreadCount(qMax(1, parser.value("jobs").toInt()));
+    }
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    QAtomicInt failures(0);
+    for (int i = 0; i < databases.size(); i++)
+    {
+        pool->start(new RenderJob(i, databases[i], names[i], options, &failures));
+    }
+    pool->waitForDone();
+
+    QTextStream out(stdout);
+    out << "{\"rendered\":" << databases.size() - failures.loadAcquire()
+        << ",\"failed\":" << failures.loadAcquire()
+        << ",\"threads\":" << pool->maxThreadCount()
+        << ",\"wallMs\":" << wallClock.elapsed()
+        << "}\n";
+
+    return failures.loadAcquire() == 0 ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+//
+// Created by zigameni on 3/9/25.
+//
+
+// Headless fast-forward run of the session pipeline: a simulated clock drives
+// Timer through days of pomodoros with pauses, skips, resets and breaks, and
+// SessionRecorder writes every session to a scratch database.
+
+#include "clock.h"
+#include "timer.h"
+#include "sessionrecorder.h"
+#include "databasemanager.h"
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+namespace
+{
+    // Runs the simulated clock until the timer has finished its session
+    void runUntilStopped(SimulatedClock& clock, Timer& timer)
+    {
+        while (timer.getState() == Timer::TimerState::Running && clock.runNextWakeup())
+        {
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pomodoro-sim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Fast-forward simulation of the Ziga-Pomodoro session pipeline");
+    parser.addHelpOption();
+    parser.addOption({"days", "Number of simulated days (default 365).", "days", "365"});
+    parser.addOption({"seed", "Random seed (default 1).", "seed", "1"});
+    parser.addOption({"db", "Database file to write (default: temporary file).", "path"});
+    parser.process(app);
+
+    int days = qMax(1, parser.value("days").toInt());
+    QRandomGenerator random(parser.value("seed").toUInt());
+
+    QTemporaryDir scratchDir;
+    QString dbPath = parser.isSet("db") ? parser.value("db") : scratchDir.filePath("sim.db");
+
+    SimulatedClock clock(QDateTime(QDate(2025, 1, 1), QTime(8, 0)));
+    Clock::setInstance(&clock);
+
+    DatabaseManager dbManager;
+    dbManager.setDatabasePath(dbPath);
+    if (!dbManager.initialize())
+    {
+        QTextStream(stderr) << "Failed to open database " << dbPath << "\n";
+        return 1;
+    }
+
+    Timer timer;
+    timer.setClock(&clock);
+    timer.setTickConsumerVisible(false); // Headless: only completion wakeups
+
+    SessionRecorder recorder(&timer);
+    recorder.setDatabaseManager(&dbManager);
+
+    int completed = 0;
+    int interrupted = 0;
+    int skippedBreaks = 0;
+    int pauses = 0;
+
+    QElapsedTimer wallClock;
+    wallClock.start();
+
+    for (int day = 0; day < days; day++)
+    {
+        QDate date = QDate(2025, 1, 1).addDays(day);
+        clock.advanceTo(QDateTime(date, QTime(8, 0)));
+
+        dbManager.beginBatch();
+
+        int sessions = 6 + random.bounded(8);
+        for (int i = 0; i < sessions; i++)
+        {
+            // Work session, sometimes paused or abandoned
+            timer.start();
+
+            if (random.bounded(4) == 0)
+            {
+                clock.advanceBy(random.bounded(60, 600) * 1000LL);
+                timer.pause();
+                pauses++;
+                clock.advanceBy(random.bounded(30, 300) * 1000LL);
+                timer.start();
+            }
+
+            if (random.bounded(20) == 0)
+            {
+                clock.advanceBy(random.bounded(60, 900) * 1000LL);
+                recorder.recordInterrupted();
+                timer.reset();
+                interrupted++;
+                continue;
+            }
+
+            runUntilStopped(clock, timer);
+            completed++;
+
+            // Break, sometimes skipped
+            if (random.bounded(6) == 0)
+            {
+                timer.skipBreak();
+                skippedBreaks++;
+                continue;
+            }
+
+            timer.start();
+            runUntilStopped(clock, timer);
+        }
+
+        dbManager.commitBatch();
+    }
+
+    qint64 elapsedMs = wallClock.elapsed();
+
+    QTextStream out(stdout);
+    out << "{\"days\":" << days
+        << ",\"completed\":" << completed
+        << ",\"interrupted\":" << interrupted
+        << ",\"pauses\":" << pauses
+        << ",\"skippedBreaks\":" << skippedBreaks
+        << ",\"recordedToday\":" << dbManager.getTotalCompletedPomodoros(clock.currentDate())
+        << ",\"wakeups\":" << timer.getWakeupCount()
+        << ",\"wallMs\":" << elapsedMs
+        << "}\n";
+
+    return 0;
+}